@@ -10,9 +10,11 @@
 #include "RealmCharacterMovementComponent.h"
 #include "RealmLaneMinionAI.h"
 #include "RealmFogofWarManager.h"
-#include "OverheadWidget.h"
 #include "Engine/ActorChannel.h"
 #include "StealthArea.h"
+#include "RealmCosmeticChannel.h"
+#include "RealmAutoAttackScheduler.h"
+#include "RealmGroundHeightfield.h"
 
 AGameCharacter::AGameCharacter(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer.SetDefaultSubobjectClass<URealmCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
@@ -46,6 +48,12 @@ AGameCharacter::AGameCharacter(const FObjectInitializer& objectInitializer)
 
 	lastTakeHitTimeTimeout = 2.f;
 	damagedSightTimeout = 2.f;
+
+	aaLaunchStartTime = 0.f;
+	aaLaunchEndTime = 0.f;
+	aaCooldownEndTime = 0.f;
+	bAutoAttackActive = false;
+	bInAutoAttackSchedule = false;
 }
 
 void AGameCharacter::BeginPlay()
@@ -62,13 +70,10 @@ void AGameCharacter::BeginPlay()
 		modManager = NewObject<UModManager>(this, FName(*modsname));
 
 		//initialize stats
-		statsManager->InitializeStats(characterData->GetDefaultObject<UGameCharacterData>()->GetCharacterBaseStats(), this);
+		statsManager->InitializeStats(characterData->GetDefaultObject<UGameCharacterData>()->GetBaseStatsForLevel(level), this);
 
 		if (IsValid(shieldManager))
-		{
 			shieldManager->owningCharacter = this;
-			shieldManager->SetOwner(this);
-		}
 
 		autoAttackManager->InitializeManager(autoAttacks, statsManager);
 		//autoAttackManager->SetOwner(playerController);
@@ -84,23 +89,6 @@ void AGameCharacter::BeginPlay()
 		//add the unit to the available sight list
 		GetWorld()->GetAuthGameMode<ARealmGameMode>()->availableSightUnits.AddUnique(this);
 	}
-
-	for (TActorIterator<AHUD> objItr(GetWorld()); objItr; ++objItr)
-	{
-		APlayerHUD* hud = Cast<APlayerHUD>((*objItr));
-		if (hud)
-			hud->AddPostRenderedActor(this);
-	}
-
-	if (overheadWidgetClass && GetNetMode() != NM_DedicatedServer)
-	{
-		overheadWidget = CreateWidget<UOverheadWidget>(GetWorld(), overheadWidgetClass);
-		if (overheadWidget)
-		{
-			overheadWidget->SetParentCharacter(this);
-			overheadWidget->AddOverheadWidgetToViewport();
-		}
-	}
 }
 
 void AGameCharacter::Destroy(bool bNetForce /* = false */, bool bShouldModifyLevel /* = true */)
@@ -112,11 +100,8 @@ void AGameCharacter::Destroy(bool bNetForce /* = false */, bool bShouldModifyLev
 	//remove from the game modes available sight list
 	GetWorld()->GetAuthGameMode<ARealmGameMode>()->availableSightUnits.Remove(this);
 
-	if (IsValid(skillManager))
-		skillManager->Destroy();
-
-	if (IsValid(shieldManager))
-		shieldManager->Destroy();
+	if (IsValid(skillManager) && HasAuthority())
+		skillManager->DestroySkills();
 
 	if (IsValid(currentStealthArea))
 		currentStealthArea->RemoveOccupyingUnit(this);
@@ -125,7 +110,6 @@ void AGameCharacter::Destroy(bool bNetForce /* = false */, bool bShouldModifyLev
 	statsManager = nullptr;
 	skillManager = nullptr;
 	modManager = nullptr;
-	overheadWidget = nullptr;
 	shieldManager = nullptr;
 
 	Super::Destroy(bNetForce, bShouldModifyLevel);
@@ -324,7 +308,7 @@ void AGameCharacter::UseMod_Implementation(int32 index, FHitResult const& hit)
 	if (!IsAlive() || !IsValid(mods[index]))
 		return;
 
-	if (mods[index]->GetCooldownRemaining() > 0.f)
+	if (GetCooldownRemaining(mods[index]) > 0.f)
 		return;
 
 	if (currentAilment.newAilment == EAilment::AL_Stun || GetWorldTimerManager().GetTimerRemaining(actionTimer) > 0.f)
@@ -353,14 +337,14 @@ void AGameCharacter::PlayHit(float DamageTaken, struct FDamageEvent const& Damag
 			AHUD* hud = PawnInstigator->playerController->GetHUD();
 			APlayerHUD* InstigatorHUD = Cast<APlayerHUD>(hud);
 			if (IsValid(InstigatorHUD))
-				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, GetActorLocation(), realmDamage);
+				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, this, realmDamage);
 		}
 		else if (IsValid(playerController))
 		{
 			AHUD* hud = playerController->GetHUD();
 			APlayerHUD* InstigatorHUD = Cast<APlayerHUD>(hud);
 			if (IsValid(InstigatorHUD))
-				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, GetActorLocation(), realmDamage);
+				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, this, realmDamage);
 		}
 	}
 
@@ -385,11 +369,13 @@ void AGameCharacter::StartAutoAttack()
 	if (bAutoAttackLaunching || bAutoAttackOnCooldown) //bAutoAttackOnCooldown || bAutoAttackLaunching
 		return;
 
-	if (GetWorldTimerManager().GetTimerRemaining(aaRangeTimer) <= 0.f)
-		GetWorldTimerManager().SetTimer(aaRangeTimer, this, &AGameCharacter::CheckAutoAttack, 1.f / 20.f, true);
+	bAutoAttackActive = true;
 
-	float distance = (GetActorLocation() - GetCurrentTarget()->GetActorLocation()).Size2D();
-	if (distance <= statsManager->GetCurrentValueForStat(EStat::ES_AARange))
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gm) && IsValid(gm->autoAttackScheduler))
+		gm->autoAttackScheduler->AddAttacker(this);
+
+	if (GetAutoAttackDistanceTo(GetCurrentTarget()) <= statsManager->GetCurrentValueForStat(EStat::ES_AARange))
 	{
 		ARealmMoveController* aicc = Cast<ARealmMoveController>(GetController());
 		if (IsValid(aicc))
@@ -399,13 +385,49 @@ void AGameCharacter::StartAutoAttack()
 		if (IsValid(aic))
 			aic->StopMovement();
 
-		float scale = statsManager->GetCurrentValueForStat(EStat::ES_AtkSp) / statsManager->GetBaseValueForStat(EStat::ES_AtkSp);
-		GetWorldTimerManager().SetTimer(aaLaunchTimer, this, &AGameCharacter::LaunchAutoAttack, autoAttackManager->GetAutoAttackLaunchTime() / scale);
-
-		bAutoAttackLaunching = true;
+		BeginAutoAttackLaunch();
 	}
 }
 
+bool AGameCharacter::UpdateAutoAttack(float currentTime)
+{
+	if (bAutoAttackOnCooldown && currentTime >= aaCooldownEndTime)
+		OnFinishAATimer();
+	else if (bAutoAttackLaunching && currentTime >= aaLaunchEndTime)
+		LaunchAutoAttack();
+	else if (bAutoAttackActive)
+		CheckAutoAttack();
+
+	return bAutoAttackActive || bAutoAttackLaunching || bAutoAttackOnCooldown;
+}
+
+void AGameCharacter::BeginAutoAttackLaunch()
+{
+	float scale = statsManager->GetCurrentValueForStat(EStat::ES_AtkSp) / statsManager->GetBaseValueForStat(EStat::ES_AtkSp);
+
+	aaLaunchStartTime = GetWorld()->GetTimeSeconds();
+	aaLaunchEndTime = aaLaunchStartTime + autoAttackManager->GetAutoAttackLaunchTime() / scale;
+
+	bAutoAttackLaunching = true;
+}
+
+float AGameCharacter::GetAutoAttackLaunchProgress() const
+{
+	if (!bAutoAttackLaunching || aaLaunchEndTime <= aaLaunchStartTime)
+		return 0.f;
+
+	return FMath::Clamp((GetWorld()->GetTimeSeconds() - aaLaunchStartTime) / (aaLaunchEndTime - aaLaunchStartTime), 0.f, 1.f);
+}
+
+float AGameCharacter::GetAutoAttackDistanceTo(AGameCharacter* other) const
+{
+	if (!IsValid(other))
+		return BIG_NUMBER;
+
+	float distance = (other->GetActorLocation() - GetActorLocation()).Size2D();
+	return FMath::Max(0.f, distance - other->GetCapsuleComponent()->GetScaledCapsuleRadius());
+}
+
 void AGameCharacter::LaunchAutoAttack()
 {
 	//GetWorldTimerManager().ClearTimer(aaRangeTimer);
@@ -490,10 +512,11 @@ void AGameCharacter::LaunchAutoAttack()
 	bAutoAttackLaunching = false;
 
 	float aaTime = 1.f / statsManager->GetCurrentValueForStat(EStat::ES_AtkSp);
-	GetWorldTimerManager().SetTimer(aaTimer, this, &AGameCharacter::OnFinishAATimer, aaTime);
+	aaCooldownEndTime = GetWorld()->GetTimeSeconds() + aaTime;
 	bAutoAttackOnCooldown = true;
 
-	GetWorldTimerManager().ClearTimer(aaRangeTimer);
+	//range isn't checked again until the cooldown finishes and the next attack starts
+	bAutoAttackActive = false;
 }
 
 bool AGameCharacter::CalculateCriticalHit(float& totalDamage, float additionalCritChance)
@@ -526,28 +549,11 @@ void AGameCharacter::CheckAutoAttack()
 	}
 
 	//if the attack is already >= 75% launched, launch anyway so there's less stuttering when auto attacking
-	if (bAutoAttackLaunching)
-	{
-		if (GetWorldTimerManager().GetTimerElapsed(aaLaunchTimer) / (GetWorldTimerManager().GetTimerElapsed(aaLaunchTimer) + GetWorldTimerManager().GetTimerRemaining(aaLaunchTimer)) >= 0.75f)
-		{
-			//GetWorldTimerManager().ClearTimer(aaRangeTimer);
-			return;
-		}
-	}
-
-	//make sure that we account for collision so we don't get stuck trying to attack
-	FVector start = GetActorLocation();
-	FVector end = GetCurrentTarget()->GetActorLocation();
-	TArray<FHitResult> hits;
-
-	GetWorld()->LineTraceMultiByChannel(hits, start, end, ECC_Pawn);
-	for (FHitResult hit : hits)
-	{
-		if (hit.GetActor() == GetCurrentTarget())
-			end = hit.ImpactPoint;
-	}
+	if (bAutoAttackLaunching && GetAutoAttackLaunchProgress() >= 0.75f)
+		return;
 
-	float distance = (end - start).Size2D();
+	//measure to the edge of the target's capsule so we don't get stuck trying to attack
+	float distance = GetAutoAttackDistanceTo(GetCurrentTarget());
 	if (distance > statsManager->GetCurrentValueForStat(EStat::ES_AARange) && !bAutoAttackLaunching)
 	{
 		//GetWorldTimerManager().ClearTimer(aaLaunchTimer);
@@ -570,10 +576,7 @@ void AGameCharacter::CheckAutoAttack()
 		if (IsValid(aic))
 			aic->StopMovement();
 
-		float scale = statsManager->GetCurrentValueForStat(EStat::ES_AtkSp) / statsManager->GetBaseValueForStat(EStat::ES_AtkSp);
-		GetWorldTimerManager().SetTimer(aaLaunchTimer, this, &AGameCharacter::LaunchAutoAttack, autoAttackManager->GetAutoAttackLaunchTime() / scale);
-
-		bAutoAttackLaunching = true;
+		BeginAutoAttackLaunch();
 
 		ARealmMoveController* aicc = Cast<ARealmMoveController>(GetController());
 		if (IsValid(aicc))
@@ -605,8 +608,7 @@ void AGameCharacter::StopAutoAttack(bool bClearCurrrentTarget)
 	if (bAutoAttackLaunching && autoAttackManager)
 		AllStopAnimMontage(autoAttackManager->GetCurrentAttackAnimation());
 
-	GetWorldTimerManager().ClearTimer(aaLaunchTimer);
-	GetWorldTimerManager().ClearTimer(aaRangeTimer);
+	bAutoAttackActive = false;
 	bAutoAttackLaunching = false;
 }
 
@@ -622,32 +624,69 @@ void AGameCharacter::PlayAutoAttackAnimation(float InPlayRate)
 	}
 }
 
-bool AGameCharacter::AllPlayAnimMontage_Validate(class UAnimMontage* AnimMontage, float InPlayRate)
+void AGameCharacter::AllPlayAnimMontage(class UAnimMontage* AnimMontage, float InPlayRate)
 {
-	return true;
+	QueueCosmeticEvent(FRealmCosmeticEvent(ECosmeticEvent::CE_PlayMontage, this, AnimMontage, InPlayRate));
 }
 
-bool AGameCharacter::AllStopAnimMontage_Validate(class UAnimMontage* AnimMontage)
+void AGameCharacter::AllStopAnimMontage(class UAnimMontage* AnimMontage)
 {
-	return true;
+	QueueCosmeticEvent(FRealmCosmeticEvent(ECosmeticEvent::CE_StopMontage, this, AnimMontage));
 }
 
-void AGameCharacter::AllPlayAnimMontage_Implementation(class UAnimMontage* AnimMontage, float InPlayRate)
+void AGameCharacter::QueueCosmeticEvent(const FRealmCosmeticEvent& cosmeticEvent)
 {
-	USkeletalMeshComponent* UseMesh = GetMesh();
-	if (AnimMontage && UseMesh && UseMesh->AnimScriptInstance)
+	if (!cosmeticEvent.asset)
+		return;
+
+	if (Role < ROLE_Authority)
 	{
-		UseMesh->AnimScriptInstance->Montage_Play(AnimMontage, InPlayRate);
+		PlayCosmeticEvent(cosmeticEvent);
+		return;
 	}
+
+	//listen server hosts get theirs through their own player controller like everyone else
+	ARealmGameMode* gameMode = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gameMode) && IsValid(gameMode->cosmeticChannel))
+		gameMode->cosmeticChannel->QueueEvent(cosmeticEvent);
 }
 
-void AGameCharacter::AllStopAnimMontage_Implementation(class UAnimMontage* AnimMontage)
+void AGameCharacter::PlayCosmeticEvent(const FRealmCosmeticEvent& cosmeticEvent)
 {
 	USkeletalMeshComponent* UseMesh = GetMesh();
-	if (AnimMontage && UseMesh && UseMesh->AnimScriptInstance &&
-		UseMesh->AnimScriptInstance->Montage_IsPlaying(AnimMontage))
+
+	switch (cosmeticEvent.eventType)
 	{
-		UseMesh->AnimScriptInstance->Montage_Stop(AnimMontage->BlendOutTime);
+	case ECosmeticEvent::CE_PlayMontage:
+	{
+		UAnimMontage* AnimMontage = Cast<UAnimMontage>(cosmeticEvent.asset);
+		if (AnimMontage && UseMesh && UseMesh->AnimScriptInstance)
+			UseMesh->AnimScriptInstance->Montage_Play(AnimMontage, cosmeticEvent.playRate);
+		break;
+	}
+	case ECosmeticEvent::CE_StopMontage:
+	{
+		UAnimMontage* AnimMontage = Cast<UAnimMontage>(cosmeticEvent.asset);
+		if (AnimMontage && UseMesh && UseMesh->AnimScriptInstance &&
+			UseMesh->AnimScriptInstance->Montage_IsPlaying(AnimMontage))
+			UseMesh->AnimScriptInstance->Montage_Stop(AnimMontage->BlendOutTime);
+		break;
+	}
+	case ECosmeticEvent::CE_Sound:
+	case ECosmeticEvent::CE_AttachedSound:
+	{
+		USoundBase* sound = Cast<USoundBase>(cosmeticEvent.asset);
+		if (!sound || bHidden)
+			break;
+
+		if (cosmeticEvent.eventType == ECosmeticEvent::CE_AttachedSound)
+			UGameplayStatics::SpawnSoundAttached(sound, GetRootComponent(), NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, false, 0.5f, 1.f, 0.f, soundAttenuation);
+		else
+			UGameplayStatics::SpawnSoundAtLocation(GetWorld(), sound, GetActorLocation(), FRotator::ZeroRotator, 0.5f, 1.f, 0.f, soundAttenuation);
+		break;
+	}
+	default:
+		break;
 	}
 }
 
@@ -674,7 +713,7 @@ UAutoAttackManager* AGameCharacter::GetAutoAttackManager() const
 	return autoAttackManager;
 }
 
-ASkillManager* AGameCharacter::GetSkillManager() const
+USkillManager* AGameCharacter::GetSkillManager() const
 {
 	return skillManager;
 }
@@ -1176,14 +1215,14 @@ void AGameCharacter::OnDeath(float KillingDamage, struct FDamageEvent const& Dam
 			AHUD* hud = gc->playerController->GetHUD();
 			APlayerHUD* InstigatorHUD = Cast<APlayerHUD>(hud);
 			if (IsValid(InstigatorHUD))
-				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, GetActorLocation(), realmDamage);
+				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, this, realmDamage);
 		}
 		else if (IsValid(playerController))
 		{
 			AHUD* hud = playerController->GetHUD();
 			APlayerHUD* InstigatorHUD = Cast<APlayerHUD>(hud);
 			if (IsValid(InstigatorHUD))
-				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, GetActorLocation(), realmDamage);
+				InstigatorHUD->NewDamageEvent(lastTakeHitInfo, this, realmDamage);
 		}
 	}
 
@@ -1287,41 +1326,57 @@ void AGameCharacter::SetTeamIndex(int32 newTeam)
 	teamIndex = newTeam;
 }
 
-void AGameCharacter::PostRenderFor(class APlayerController* PC, class UCanvas* Canvas, FVector CameraPosition, FVector CameraDir)
+float AGameCharacter::GetServerTime() const
 {
-	if (!IsValid(Cast<ARealmPlayerController>(PC)) || !IsValid(Cast<ARealmPlayerController>(PC)->GetPlayerCharacter()))
-		return;
-
-	int32 otherTeam = Cast<ARealmPlayerController>(PC)->GetPlayerCharacter()->GetTeamIndex();
-	otherTeam == teamIndex ? Canvas->SetDrawColor(FColor::Blue) : Canvas->SetDrawColor(FColor::Red);
+	AGameState* gs = GetWorld()->GetGameState();
+	return IsValid(gs) ? gs->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
 
-	if (!overheadWidget)
+void AGameCharacter::StartCooldown(AActor* source, float duration)
+{
+	if (Role < ROLE_Authority || !IsValid(source))
 		return;
 
-	if (IsAlive())
+	const float serverTime = GetServerTime();
+
+	//reuse the source's slot, and drop slots of mods that have been sold
+	FRealmCooldown* entry = nullptr;
+	for (int32 i = cooldowns.Num() - 1; i >= 0; i--)
 	{
-		const FVector2D ViewportSize = FVector2D(GEngine->GameViewport->Viewport->GetSizeXY());
+		if (!IsValid(cooldowns[i].source))
+			cooldowns.RemoveAt(i);
+		else if (cooldowns[i].source == source)
+			entry = &cooldowns[i];
+	}
 
-		overheadWidget->SetVisibility(ESlateVisibility::Visible);
+	if (!entry)
+		entry = &cooldowns[cooldowns.Add(FRealmCooldown(source, serverTime, serverTime))];
 
-		if (bHidden)
-			overheadWidget->SetVisibility(ESlateVisibility::Hidden);
-		else
-			overheadWidget->SetVisibility(ESlateVisibility::Visible);
+	entry->startTime = serverTime;
+	entry->endTime = serverTime + FMath::Max(0.f, duration);
+}
 
-		FVector hudPos = GetActorLocation();
-		hudPos.Z += GetSimpleCollisionHalfHeight() * overheadHalfHeightMultiplier;
+const FRealmCooldown* AGameCharacter::FindCooldown(const AActor* source) const
+{
+	for (const FRealmCooldown& cooldown : cooldowns)
+	{
+		if (cooldown.source == source)
+			return &cooldown;
+	}
 
-		FVector screenPos = Canvas->Project(hudPos);
-		screenPos.X -= overheadWidget->GetDesiredSize().X / 4.f;
+	return nullptr;
+}
 
-		float xRatio = Canvas->SizeX / ViewportSize.X;
-		float yRatio = Canvas->SizeY / ViewportSize.Y;
+float AGameCharacter::GetCooldownRemaining(const AActor* source) const
+{
+	const FRealmCooldown* cooldown = FindCooldown(source);
+	return cooldown ? cooldown->GetRemaining(GetServerTime()) : 0.f;
+}
 
-		overheadWidget->SetPositionInViewport(FVector2D(xRatio * screenPos.X, yRatio * screenPos.Y));
-	}
-	else
-		overheadWidget->SetVisibility(ESlateVisibility::Hidden);
+float AGameCharacter::GetCooldownProgressPercent(const AActor* source) const
+{
+	const FRealmCooldown* cooldown = FindCooldown(source);
+	return cooldown ? cooldown->GetProgressPercent(GetServerTime()) : 0.f;
 }
 
 void AGameCharacter::AddMod(AMod* newMod)
@@ -1388,6 +1443,12 @@ void AGameCharacter::CharacterDash(FVector dashEndLocation, float spdScale)
 		rmc->DashLaunch(dashEndLocation, spdScale);
 		CharacterDashStarted();
 
+		replicatedDash.startLocation = GetActorLocation();
+		replicatedDash.endLocation = dashEndLocation;
+		replicatedDash.speed = DASH_SPEED * spdScale;
+		replicatedDash.serverStartTime = GetServerTime();
+		replicatedDash.dashCount++;
+
 		bAcceptingMoveCommands = false;
 	}
 }
@@ -1418,7 +1479,7 @@ void AGameCharacter::GiveCharacterExperience(int32 amount)
 
 void AGameCharacter::LevelUp()
 {
-	if (level + 1 > 15)
+	if (level + 1 > MAX_LEVEL)
 		return;
 
 	level++;
@@ -1427,18 +1488,30 @@ void AGameCharacter::LevelUp()
 	if (Role == ROLE_Authority)
 		GetWorld()->GetAuthGameMode<ARealmGameMode>()->PlayerLeveledUp();
 
-	if (IsValid(statsManager))
-		statsManager->CharacterLevelUp();
+	if (IsValid(statsManager) && *characterData)
+	{
+		const UGameCharacterData* data = characterData->GetDefaultObject<UGameCharacterData>();
+		statsManager->CharacterLevelUp(data->GetBaseStatsForLevel(level - 1), data->GetBaseStatsForLevel(level));
+	}
 }
 
 void AGameCharacter::InitCharacterStatsForLevel(int32 newlevel)
 {
+	newlevel = FMath::Min(newlevel, MAX_LEVEL);
 	int32 deltaLvl = newlevel - level;
 
-	if (deltaLvl > 0)
+	if (deltaLvl <= 0)
+		return;
+
+	//jump straight to the new level's row instead of leveling up one at a time
+	const int32 previousLevel = level;
+	level = newlevel;
+	skillPoints += deltaLvl;
+
+	if (IsValid(statsManager) && *characterData)
 	{
-		for (int32 i = 0; i < deltaLvl; i++)
-			LevelUp();
+		const UGameCharacterData* data = characterData->GetDefaultObject<UGameCharacterData>();
+		statsManager->CharacterLevelUp(data->GetBaseStatsForLevel(previousLevel), data->GetBaseStatsForLevel(newlevel), deltaLvl);
 	}
 }
 
@@ -1456,6 +1529,45 @@ void AGameCharacter::OnRepAilment()
 	GetWorldTimerManager().SetTimer(ailmentTimer, currentAilment.ailmentDuration, false);
 }
 
+void AGameCharacter::OnRep_Dash()
+{
+	URealmCharacterMovementComponent* rmc = Cast<URealmCharacterMovementComponent>(GetCharacterMovement());
+	if (!rmc || replicatedDash.dashCount == 0 || replicatedDash.speed <= 0.f)
+		return;
+
+	//the initial bunch, from joining or coming back into relevancy, carries whatever dash happened last. the replicated
+	//location already has the character where it ended up
+	if (!HasActorBegunPlay())
+		return;
+
+	//same for a dash that finished on the server before it got here, only the replicated location can place it now
+	const float elapsed = GetServerTime() - replicatedDash.serverStartTime;
+	const float duration = FVector::Dist(replicatedDash.startLocation, replicatedDash.endLocation) / replicatedDash.speed;
+	if (elapsed >= duration)
+		return;
+
+	rmc->SimulateDash(replicatedDash.startLocation, replicatedDash.endLocation, replicatedDash.speed, elapsed);
+}
+
+void AGameCharacter::PostNetReceiveLocationAndRotation()
+{
+	if (Role == ROLE_SimulatedProxy)
+	{
+		URealmCharacterMovementComponent* rmc = Cast<URealmCharacterMovementComponent>(GetCharacterMovement());
+		if (rmc)
+		{
+			//a dash being played out locally already knows where it ends
+			if (rmc->IsSimulatingDash())
+				return;
+
+			if (rmc->IsPredictingMove() && rmc->ReconcileServerLocation(ReplicatedMovement.Location))
+				return;
+		}
+	}
+
+	Super::PostNetReceiveLocationAndRotation();
+}
+
 void AGameCharacter::OnRep_AutoAttackLaunching()
 {
 	if (bAutoAttackLaunching)
@@ -1707,7 +1819,7 @@ void AGameCharacter::OnUpgradeSkill(int32 index)
 	if (skillPoints <= 0)
 		return;
 
-	ASkillManager* sm = GetSkillManager();
+	USkillManager* sm = GetSkillManager();
 	if (IsValid(sm))
 	{
 		int32 prevSkill = -1;
@@ -1722,15 +1834,9 @@ void AGameCharacter::OnUpgradeSkill(int32 index)
 	}
 }
 
-void AGameCharacter::PlayCharacterSound_Implementation(USoundBase* sound, bool bAttachedToCharacter /* = false */)
+void AGameCharacter::PlayCharacterSound(USoundBase* sound, bool bAttachedToCharacter /* = false */)
 {
-	if (!sound || bHidden)
-		return;
-
-	if (bAttachedToCharacter)
-		UGameplayStatics::SpawnSoundAttached(sound, GetRootComponent(), NAME_None, FVector(ForceInit), EAttachLocation::KeepRelativeOffset, false, 0.5f, 1.f, 0.f, soundAttenuation);
-	else
-		UGameplayStatics::SpawnSoundAtLocation(GetWorld(), sound, GetActorLocation(), FRotator::ZeroRotator, 0.5f, 1.f, 0.f, soundAttenuation);
+	QueueCosmeticEvent(FRealmCosmeticEvent(bAttachedToCharacter ? ECosmeticEvent::CE_AttachedSound : ECosmeticEvent::CE_Sound, this, sound));
 }
 
 void AGameCharacter::AddShield(FCharacterShield newShield)
@@ -1759,15 +1865,7 @@ FVector AGameCharacter::FindGroundBeneathCharacter(AGameCharacter* testCharacter
 	if (!IsValid(testCharacter))
 		return FVector::ZeroVector;
 
-	FVector start = testCharacter->GetActorLocation();
-	FVector end = start;
-	end.Z -= 10000.f;
-
-	FHitResult hit;
-	if (testCharacter->GetWorld()->LineTraceSingleByChannel(hit, start, end, ECC_WorldStatic))
-		return hit.ImpactPoint;
-	else
-		return testCharacter->GetActorLocation();
+	return FRealmGroundHeightfield::FindGroundBeneathPoint(testCharacter->GetWorld(), testCharacter->GetActorLocation(), 10000.f);
 }
 
 bool AGameCharacter::CanSeeOtherCharacter(AGameCharacter* testCharacter, bool bTestForThisCharacter)
@@ -1794,13 +1892,10 @@ bool AGameCharacter::CanSeeOtherCharacter(AGameCharacter* testCharacter, bool bT
 	if (dist > sightRadius)
 		return false;
 
-	//check the first fow manager we find for this team and see if we can see the tested character
-	for (TObjectIterator<URealmFogofWarManager> Itr; Itr; ++Itr)
-	{
-		URealmFogofWarManager* fow = (*Itr);
-		if (IsValid(fow))
-			return fow->CanUnitSeeOther(this, testCharacter);
-	}
+	//ask this world's fow manager, other matches in the process have their own
+	ARealmGameMode* gameMode = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	if (IsValid(gameMode) && IsValid(gameMode->fogOfWar))
+		return gameMode->fogOfWar->CanUnitSeeOther(this, testCharacter);
 
 	return false;
 }
@@ -1845,6 +1940,10 @@ void AGameCharacter::PreReplication(IRepChangedPropertyTracker & ChangedProperty
 {
 	Super::PreReplication(ChangedPropertyTracker);
 
+	//stats replicate through a quantized copy that is refreshed right before the stats manager goes out
+	if (IsValid(statsManager))
+		statsManager->UpdateReplicatedStats();
+
 	// Only replicate this property for a short duration after it changes so join in progress players don't get spammed with fx when joining late
 	DOREPLIFETIME_ACTIVE_OVERRIDE(AGameCharacter, lastTakeHitInfo, GetWorld() && GetWorld()->GetTimeSeconds() < lastTakeHitTimeTimeout);
 }
@@ -1862,6 +1961,12 @@ bool AGameCharacter::ReplicateSubobjects(class UActorChannel *Channel, class FOu
 	if (modManager)
 		WroteSomething |= Channel->ReplicateSubobject(modManager, *Bunch, *RepFlags);
 
+	if (skillManager)
+		WroteSomething |= Channel->ReplicateSubobject(skillManager, *Bunch, *RepFlags);
+
+	if (shieldManager)
+		WroteSomething |= Channel->ReplicateSubobject(shieldManager, *Bunch, *RepFlags);
+
 	return WroteSomething;
 }
 
@@ -1880,6 +1985,8 @@ void AGameCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & Ou
 	DOREPLIFETIME(AGameCharacter, skillPoints);
 	DOREPLIFETIME(AGameCharacter, experienceAmount);
 	DOREPLIFETIME(AGameCharacter, mods);
+	DOREPLIFETIME(AGameCharacter, cooldowns);
+	DOREPLIFETIME(AGameCharacter, replicatedDash);
 	DOREPLIFETIME(AGameCharacter, bIsTargetable);
 	DOREPLIFETIME(AGameCharacter, bAutoAttackLaunching);
 	DOREPLIFETIME(AGameCharacter, currentStealthArea);
@@ -1,6 +1,7 @@
 #include "Realm.h"
 #include "GameCharacterData.h"
 #include "StatsManager.h"
+#include "GameCharacter.h"
 
 UGameCharacterData::UGameCharacterData(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -8,13 +9,37 @@ UGameCharacterData::UGameCharacterData(const FObjectInitializer& objectInitializ
 
 }
 
-float* UGameCharacterData::GetCharacterBaseStats() const
+void UGameCharacterData::PostInitProperties()
 {
-	float* baseStats = new float[(uint8)EStat::ES_Max];
+	Super::PostInitProperties();
 
-	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
-		baseStats[i] = 0.f;
+	BuildLevelStatTable();
+}
+
+void UGameCharacterData::PostLoad()
+{
+	Super::PostLoad();
+
+	//blueprint defaults are serialized in after PostInitProperties
+	BuildLevelStatTable();
+}
 
+#if WITH_EDITOR
+void UGameCharacterData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildLevelStatTable();
+}
+#endif
+
+void UGameCharacterData::BuildLevelStatTable()
+{
+	const int32 statCount = (int32)EStat::ES_Max;
+
+	levelStatTable.Init(0.f, MAX_LEVEL * statCount);
+
+	float* baseStats = levelStatTable.GetData();
 	baseStats[(uint8)EStat::ES_Atk] = attack;
 	baseStats[(uint8)EStat::ES_Def] = defense;
 	baseStats[(uint8)EStat::ES_AtkPL] = attackPerLevel;
@@ -35,5 +60,23 @@ float* UGameCharacterData::GetCharacterBaseStats() const
 	baseStats[(uint8)EStat::ES_FlareRegen] = flareRegen;
 	baseStats[(uint8)EStat::ES_FlareRegenPL] = flareRegenPerLevel;
 
-	return baseStats;
-}
\ No newline at end of file
+	//every level after the first is the one before it plus the per level growth
+	for (int32 level = 1; level < MAX_LEVEL; level++)
+	{
+		const float* previous = baseStats + (level - 1) * statCount;
+		float* current = baseStats + level * statCount;
+
+		FMemory::Memcpy(current, previous, statCount * sizeof(float));
+
+		for (int32 i = 0; i < LEVELED_STAT_COUNT; i++)
+			current[(int32)LEVELED_STATS[i][0]] += previous[(int32)LEVELED_STATS[i][1]];
+	}
+}
+
+const float* UGameCharacterData::GetBaseStatsForLevel(int32 level) const
+{
+	check(levelStatTable.Num() == MAX_LEVEL * (int32)EStat::ES_Max);
+
+	const int32 row = FMath::Clamp(level, 1, MAX_LEVEL) - 1;
+	return levelStatTable.GetData() + row * (int32)EStat::ES_Max;
+}
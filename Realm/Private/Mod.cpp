@@ -1,6 +1,7 @@
 #include "Realm.h"
 #include "Mod.h"
 #include "PlayerCharacter.h"
+#include "UnrealNetwork.h"
 
 AMod::AMod(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -209,25 +210,20 @@ void AMod::GetRecipe(TArray<TSubclassOf<AMod> >& recipeClasses)
 	}
 }
 
-void AMod::StartCooldown_Implementation(float cooldownTime)
+void AMod::StartCooldown(float cooldownTime)
 {
-	GetWorldTimerManager().SetTimer(cooldownTimer, cooldownTime, false);
+	if (IsValid(characterOwner))
+		characterOwner->StartCooldown(this, cooldownTime);
 }
 
 float AMod::GetCooldownRemaining()
 {
-	return GetWorldTimerManager().GetTimerRemaining(cooldownTimer);
+	return IsValid(characterOwner) ? characterOwner->GetCooldownRemaining(this) : 0.f;
 }
 
 float AMod::GetCooldownProgressPercent()
 {
-	if (GetWorldTimerManager().GetTimerRemaining(cooldownTimer) <= 0.f)
-		return 0.f;
-
-	float timeElapsed = GetWorldTimerManager().GetTimerElapsed(cooldownTimer);
-	float totalTime = timeElapsed + GetWorldTimerManager().GetTimerRemaining(cooldownTimer);
-
-	return timeElapsed / totalTime;
+	return IsValid(characterOwner) ? characterOwner->GetCooldownProgressPercent(this) : 0.f;
 }
 
 void AMod::GetUIRecipeForMod(TSubclassOf<AMod> modClass, TArray<TSubclassOf<AMod> >& recipeArray)
@@ -256,4 +252,11 @@ int32 AMod::GetUIRecipeCost(TSubclassOf<AMod> modClass)
 	}
 
 	return cost;
-}
\ No newline at end of file
+}
+
+void AMod::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AMod, characterOwner);
+}
@@ -5,6 +5,7 @@
 #include "RealmPlayerController.h"
 #include "RealmPlayerState.h"
 #include "PlayerHUD.h"
+#include "RealmLagCompensation.h"
 
 APlayerCharacter::APlayerCharacter(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
@@ -17,18 +18,22 @@ APlayerCharacter::APlayerCharacter(const FObjectInitializer& objectInitializer)
 
 void APlayerCharacter::BeginPlay()
 {
-	skillManager = GetWorld()->SpawnActor<ASkillManager>(GetActorLocation(), GetActorRotation());
-	skillManager->SetOwner(this);
-	shieldManager = GetWorld()->SpawnActor<AShieldManager>();
-	shieldManager->SetOwner(this);
-
-	for (int32 i = 0; i < skillClasses.Num(); i++)
+	//clients get the managers and skills through replication
+	if (HasAuthority())
 	{
-		ASkill* newSkill = GetWorld()->SpawnActor<ASkill>(skillClasses[i], GetActorLocation(), GetActorRotation());
-		if (newSkill)
+		FString skillsname = GetFName().ToString() + ".skillManager";
+		skillManager = NewObject<USkillManager>(this, FName(*skillsname));
+		FString shieldsname = GetFName().ToString() + ".shieldManager";
+		shieldManager = NewObject<UShieldManager>(this, FName(*shieldsname));
+
+		for (int32 i = 0; i < skillClasses.Num(); i++)
 		{
-			newSkill->InitializeSkill(this);
-			skillManager->AddSkill(newSkill);
+			ASkill* newSkill = GetWorld()->SpawnActor<ASkill>(skillClasses[i], GetActorLocation(), GetActorRotation());
+			if (newSkill)
+			{
+				newSkill->InitializeSkill(this);
+				skillManager->AddSkill(newSkill);
+			}
 		}
 	}
 
@@ -126,6 +131,10 @@ void APlayerCharacter::Respawn()
 		if (IsValid(playerController))
 			PlayerState = playerController->PlayerState;
 
+		URealmLagCompensation* lagCompensation = URealmLagCompensation::Get(GetWorld());
+		if (lagCompensation)
+			lagCompensation->MarkTeleported(this);
+
 		AActor* start = GetWorld()->GetAuthGameMode<ARealmGameMode>()->FindPlayerStart(IsValid(playerController) ? playerController : GetController());
 		if (start)
 			SetActorLocation(start->GetActorLocation());
@@ -261,19 +270,20 @@ void APlayerCharacter::StopBaseTeleport_Implementation()
 	}
 }
 
-void APlayerCharacter::PerformBaseTeleport_Implementation()
+void APlayerCharacter::PerformBaseTeleport()
 {
-	if (bIsDying)
+	if (bIsDying || Role < ROLE_Authority)
 		return;
 
-	if (Role == ROLE_Authority)
-	{
-		AActor* start = GetWorld()->GetAuthGameMode<ARealmGameMode>()->FindPlayerStart(playerController);
-		if (start)
-			SetActorLocation(start->GetActorLocation());
-		else
-			SetActorLocation(playerController->StartSpot->GetActorLocation());
-	}
+	URealmLagCompensation* lagCompensation = URealmLagCompensation::Get(GetWorld());
+	if (lagCompensation)
+		lagCompensation->MarkTeleported(this);
+
+	AActor* start = GetWorld()->GetAuthGameMode<ARealmGameMode>()->FindPlayerStart(playerController);
+	if (start)
+		SetActorLocation(start->GetActorLocation());
+	else
+		SetActorLocation(playerController->StartSpot->GetActorLocation());
 }
 
 void APlayerCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
@@ -4,6 +4,7 @@
 #include "DamageTypes.h"
 #include "MinimapActor.h"
 #include "RealmPlayerController.h"
+#include "PlayerCharacter.h"
 
 APlayerHUD::APlayerHUD(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -15,39 +16,175 @@ APlayerHUD::APlayerHUD(const FObjectInitializer& objectInitializer)
 		uiFont = fontClass.Object;
 	}
 
-	bShowOverlays = true;
+	bShowOverlays = false;
 	mapPosition = FVector2D(0.8f, 0.7f);
 	mapDimensions = 300.f;
+
+	heroBarSize = FVector2D(125.f, 12.f);
+	unitBarSize = FVector2D(75.f, 6.f);
+	flareBarHeight = 4.f;
+	activeOverheadLabels = 0;
+
+	pickPadding = 6.f;
+
+	floatingDamagePoolSize = 32;
+	floatingDamageMergeWindow = 0.1f;
+	floatingDamageLifetime = 1.f;
+	floatingDamageRiseSpeed = 60.f;
+	mergedDamageEvents = 0;
+	droppedDamageEvents = 0;
+	evictedDamageEvents = 0;
 }
 
-void APlayerHUD::NewDamageEvent(FTakeHitInfo hitInfo, FVector worldPosition, FRealmDamage& realmdmg)
+void APlayerHUD::NewDamageEvent(FTakeHitInfo hitInfo, AGameCharacter* damagedCharacter, FRealmDamage& realmdmg)
 {
+	if (!IsValid(damagedCharacter) || floatingDamage.Num() <= 0)
+		return;
+
+	const float currentTime = GetWorld()->TimeSeconds;
+
+	//sum rapid hits on the same target (dot ticks, minion waves) into the entry already showing
+	for (FUIDamage& active : floatingDamage)
+	{
+		if (active.bActive && active.damagedCharacter.Get() == damagedCharacter && active.damageType == hitInfo.DamageTypeClass &&
+			active.realmDamage.damageSource == realmdmg.damageSource && active.realmDamage.bCriticalHit == realmdmg.bCriticalHit &&
+			currentTime - active.lastHitTime <= floatingDamageMergeWindow)
+		{
+			active.amount += hitInfo.ActualDamage;
+			active.lastHitTime = currentTime;
+			active.hitCount++;
+			active.worldPosition = damagedCharacter->GetOverheadLocation();
+			active.displayText = FText::AsNumber(FMath::RoundToInt(active.amount));
+
+			mergedDamageEvents++;
+			return;
+		}
+	}
+
 	FUIDamage dmg;
 
 	dmg.amount = hitInfo.ActualDamage;
-	dmg.originTime = GetWorld()->TimeSeconds;
-	dmg.worldPosition = worldPosition;
+	dmg.originTime = currentTime;
+	dmg.lastHitTime = currentTime;
+	dmg.worldPosition = damagedCharacter->GetOverheadLocation();
 	dmg.damageType = hitInfo.DamageTypeClass;
 	dmg.realmDamage = realmdmg;
+	dmg.damagedCharacter = damagedCharacter;
+	dmg.hitCount = 1;
+	dmg.bActive = true;
+	dmg.displayText = FText::AsNumber(FMath::RoundToInt(dmg.amount));
+	dmg.priority = GetFloatingDamagePriority(dmg);
+
+	//take a free slot, otherwise the oldest of the lowest priority entries
+	int32 slot = INDEX_NONE;
+	for (int32 i = 0; i < floatingDamage.Num(); i++)
+	{
+		const FUIDamage& entry = floatingDamage[i];
+		if (!entry.bActive)
+		{
+			slot = i;
+			break;
+		}
 
-	FVector2D screenPos;
-	UGameplayStatics::ProjectWorldToScreen(PlayerOwner, dmg.worldPosition, screenPos);
+		if (slot == INDEX_NONE || entry.priority < floatingDamage[slot].priority ||
+			(entry.priority == floatingDamage[slot].priority && entry.lastHitTime < floatingDamage[slot].lastHitTime))
+			slot = i;
+	}
 
-	//floatingDamage.Add(dmg);
-	ShowDamageText(dmg);
+	if (floatingDamage[slot].bActive)
+	{
+		if (floatingDamage[slot].priority > dmg.priority)
+		{
+			droppedDamageEvents++;
+			return;
+		}
+
+		evictedDamageEvents++;
+	}
+
+	floatingDamage[slot] = dmg;
 }
 
-void APlayerHUD::BeginPlay()
+int32 APlayerHUD::GetFloatingDamagePriority(const FUIDamage& dmg) const
 {
-	Super::BeginPlay();
+	int32 priority = 0;
+
+	if (dmg.realmDamage.bCriticalHit)
+		priority += 4;
+
+	//damage to our own character matters more than damage we're dealing
+	ARealmPlayerController* pc = Cast<ARealmPlayerController>(PlayerOwner);
+	if (IsValid(pc) && dmg.damagedCharacter.Get() == pc->GetPlayerCharacter())
+		priority += 2;
+
+	if (dmg.realmDamage.damageSource == ERealmDamageSource::ERDS_Skill)
+		priority += 1;
+
+	return priority;
+}
 
-	//get overlay actors
-	for (TActorIterator<AGameCharacter> objItr(GetWorld()); objItr; ++objItr)
+void APlayerHUD::DrawFloatingDamage()
+{
+	const float currentTime = GetWorld()->TimeSeconds;
+	UFont* font = IsValid(uiFont) ? uiFont : GEngine->GetMediumFont();
+
+	FCanvasTextItem textItem(FVector2D::ZeroVector, FText::GetEmpty(), font, FLinearColor::White);
+	textItem.bCentreX = true;
+	textItem.bOutlined = true;
+
+	for (FUIDamage& dmg : floatingDamage)
 	{
-		AddPostRenderedActor((*objItr));
+		if (!dmg.bActive)
+			continue;
+
+		const float age = currentTime - dmg.lastHitTime;
+		if (age > floatingDamageLifetime)
+		{
+			dmg.bActive = false;
+			dmg.damagedCharacter = nullptr;
+			continue;
+		}
+
+		//follow the target while it's still around and visible
+		AGameCharacter* damagedCharacter = dmg.damagedCharacter.Get();
+		if (IsValid(damagedCharacter))
+		{
+			if (damagedCharacter->bHidden)
+				continue;
+
+			dmg.worldPosition = damagedCharacter->GetOverheadLocation();
+		}
+
+		FVector screenPos = Canvas->Project(dmg.worldPosition);
+		if (screenPos.Z <= 0.f)
+			continue;
+
+		FLinearColor color = FLinearColor::White;
+		if (dmg.realmDamage.damageSource == ERealmDamageSource::ERDS_Skill)
+			color = FLinearColor(1.f, 0.5f, 0.f);
+		else if (dmg.realmDamage.damageSource == ERealmDamageSource::ERDS_Effect)
+			color = FLinearColor(0.7f, 0.3f, 1.f);
+		if (dmg.realmDamage.bCriticalHit)
+			color = FLinearColor::Yellow;
+		color.A = FMath::Clamp(1.f - (age / floatingDamageLifetime), 0.f, 1.f);
+
+		const float scale = dmg.realmDamage.bCriticalHit ? 1.5f : 1.f;
+
+		textItem.Text = dmg.displayText;
+		textItem.Position = FVector2D(screenPos.X, screenPos.Y - ((currentTime - dmg.originTime) * floatingDamageRiseSpeed));
+		textItem.Scale = FVector2D(scale, scale);
+		textItem.SetColor(color);
+		Canvas->DrawItem(textItem);
 	}
+}
+
+void APlayerHUD::BeginPlay()
+{
+	Super::BeginPlay();
 
-	//then get minimap actors
+	floatingDamage.SetNum(FMath::Max(floatingDamagePoolSize, 1));
+
+	//get minimap actors
 	for (TActorIterator<AMinimapActor> mapItr(GetWorld()); mapItr; ++mapItr)
 		gameMinimap = (*mapItr);
 }
@@ -56,10 +193,183 @@ void APlayerHUD::DrawHUD()
 {
 	Super::DrawHUD();
 
-	//DrawActorOverlays(FVector::ZeroVector, FRotator::ZeroRotator);
+	GatherVisibleCharacters();
+	BuildPickableCharacters();
+	DrawOverheadBars();
+	DrawFloatingDamage();
 	DrawMinimap();
 }
 
+void APlayerHUD::GatherVisibleCharacters()
+{
+	visibleCharacters.Reset();
+
+	for (TActorIterator<AGameCharacter> unititr(GetWorld()); unititr; ++unititr)
+	{
+		AGameCharacter* gc = (*unititr);
+		if (IsValid(gc) && gc->IsAlive() && !gc->bHidden) //fog of war hides units by hiding the actor
+			visibleCharacters.Add(gc);
+	}
+}
+
+void APlayerHUD::BuildPickableCharacters()
+{
+	pickableCharacters.Reset();
+
+	if (!IsValid(PlayerOwner) || !IsValid(PlayerOwner->PlayerCameraManager))
+		return;
+
+	const FVector cameraLocation = PlayerOwner->PlayerCameraManager->GetCameraLocation();
+	const FVector cameraRight = FRotationMatrix(PlayerOwner->PlayerCameraManager->GetCameraRotation()).GetScaledAxis(EAxis::Y);
+
+	for (AGameCharacter* gc : visibleCharacters)
+	{
+		if (!gc->IsTargetable())
+			continue;
+
+		const FVector center = gc->GetActorLocation();
+		const float halfHeight = gc->GetSimpleCollisionHalfHeight();
+		const float radius = gc->GetSimpleCollisionRadius();
+
+		FVector top = Canvas->Project(center + FVector(0.f, 0.f, halfHeight));
+		FVector bottom = Canvas->Project(center - FVector(0.f, 0.f, halfHeight));
+		FVector side = Canvas->Project(center + cameraRight * radius);
+		FVector middle = Canvas->Project(center);
+
+		if (top.Z <= 0.f || bottom.Z <= 0.f || middle.Z <= 0.f)
+			continue;
+
+		const float halfWidth = FMath::Abs(side.X - middle.X) + pickPadding;
+
+		FScreenPickEntry entry;
+		entry.character = gc;
+		entry.screenBounds = FBox2D(FVector2D(middle.X - halfWidth, FMath::Min(top.Y, bottom.Y) - pickPadding), FVector2D(middle.X + halfWidth, FMath::Max(top.Y, bottom.Y) + pickPadding));
+		entry.cameraDistSq = FVector::DistSquared(cameraLocation, center);
+
+		//throw out anything that's entirely off the screen
+		if (entry.screenBounds.Max.X < 0.f || entry.screenBounds.Min.X > Canvas->ClipX || entry.screenBounds.Max.Y < 0.f || entry.screenBounds.Min.Y > Canvas->ClipY)
+			continue;
+
+		pickableCharacters.Add(entry);
+	}
+}
+
+void APlayerHUD::DrawOverheadBars()
+{
+	ARealmPlayerController* pc = Cast<ARealmPlayerController>(PlayerOwner);
+	if (!IsValid(pc) || !IsValid(pc->GetPlayerCharacter()))
+		return;
+
+	APlayerCharacter* localCharacter = pc->GetPlayerCharacter();
+	int32 localTeam = localCharacter->GetTeamIndex();
+
+	overheadBarTris.Reset();
+	activeOverheadLabels = 0;
+
+	for (AGameCharacter* gc : visibleCharacters)
+	{
+		UStatsManager* sm = gc->GetStatsManager();
+		if (!IsValid(sm))
+			continue;
+
+		const bool bIsHero = gc->IsA(APlayerCharacter::StaticClass());
+		const FVector2D barSize = bIsHero ? heroBarSize : unitBarSize;
+
+		//behind the camera or off the screen
+		FVector screenPos = Canvas->Project(gc->GetOverheadLocation());
+		if (screenPos.Z <= 0.f || screenPos.X < -barSize.X || screenPos.X > Canvas->ClipX + barSize.X || screenPos.Y < -barSize.Y || screenPos.Y > Canvas->ClipY + barSize.Y)
+			continue;
+
+		const float maxHealth = sm->GetCurrentValueForStat(EStat::ES_HP);
+		if (maxHealth <= 0.f)
+			continue;
+
+		FLinearColor barColor = gc->GetTeamIndex() == localTeam ? FLinearColor::Blue : FLinearColor::Red;
+		if (gc == localCharacter)
+			barColor = FLinearColor::Yellow;
+
+		const FVector2D barPos(screenPos.X - (barSize.X / 2.f), screenPos.Y);
+		const float healthPercent = FMath::Clamp(sm->GetHealth() / maxHealth, 0.f, 1.f);
+
+		//health bar
+		AddOverheadQuad(barPos, barSize, FLinearColor::Black);
+		AddOverheadQuad(barPos, FVector2D(healthPercent * barSize.X, barSize.Y), barColor);
+
+		//shield bar, drawn over the end of the health bar
+		UShieldManager* shields = gc->GetShieldManager();
+		if (IsValid(shields) && shields->GetTotalShieldAmount() > 0.f)
+		{
+			const float shieldWidth = FMath::Min(shields->GetTotalShieldAmount() / maxHealth, 1.f) * barSize.X;
+			const float shieldStart = FMath::Max(barPos.X + (healthPercent * barSize.X) - shieldWidth, barPos.X);
+			AddOverheadQuad(FVector2D(shieldStart, barPos.Y), FVector2D(shieldWidth, barSize.Y), FLinearColor::White);
+		}
+
+		if (bIsHero)
+		{
+			//flare bar
+			const float maxFlare = sm->GetCurrentValueForStat(EStat::ES_Flare);
+			const FVector2D flarePos(barPos.X, barPos.Y + barSize.Y);
+			AddOverheadQuad(flarePos, FVector2D(barSize.X, flareBarHeight), FLinearColor::Black);
+			if (maxFlare > 0.f)
+				AddOverheadQuad(flarePos, FVector2D(FMath::Clamp(sm->GetFlare() / maxFlare, 0.f, 1.f) * barSize.X, flareBarHeight), FLinearColor(0.f, 0.6f, 1.f));
+
+			AddOverheadLabel(gc, FVector2D(barPos.X, barPos.Y - 16.f), barColor);
+		}
+	}
+
+	//every bar goes out in one batch, then the labels on top of them
+	if (overheadBarTris.Num() > 0)
+	{
+		FCanvasTriangleItem barItem(overheadBarTris, GWhiteTexture);
+		Canvas->DrawItem(barItem);
+	}
+
+	for (int32 i = 0; i < activeOverheadLabels; i++)
+		Canvas->DrawItem(overheadLabelPool[i].textItem);
+}
+
+void APlayerHUD::AddOverheadQuad(const FVector2D& position, const FVector2D& size, const FLinearColor& color)
+{
+	if (size.X <= 0.f || size.Y <= 0.f)
+		return;
+
+	FCanvasUVTri tri;
+	tri.V0_Color = tri.V1_Color = tri.V2_Color = color;
+	tri.V0_UV = tri.V1_UV = tri.V2_UV = FVector2D::ZeroVector;
+
+	tri.V0_Pos = position;
+	tri.V1_Pos = FVector2D(position.X + size.X, position.Y);
+	tri.V2_Pos = position + size;
+	overheadBarTris.Add(tri);
+
+	tri.V1_Pos = position + size;
+	tri.V2_Pos = FVector2D(position.X, position.Y + size.Y);
+	overheadBarTris.Add(tri);
+}
+
+void APlayerHUD::AddOverheadLabel(AGameCharacter* gc, const FVector2D& position, const FLinearColor& color)
+{
+	if (activeOverheadLabels >= overheadLabelPool.Num())
+		overheadLabelPool.AddDefaulted();
+
+	FOverheadLabel& label = overheadLabelPool[activeOverheadLabels++];
+
+	//only rebuild the text when this slot was last used for someone else
+	if (label.labelOwner.Get() != gc)
+	{
+		label.labelOwner = gc;
+
+		if (IsValid(gc->PlayerState))
+			label.textItem.Text = FText::FromString(gc->PlayerState->PlayerName);
+		else
+			gc->GetCharacterName(label.textItem.Text);
+	}
+
+	label.textItem.Position = position;
+	label.textItem.SetColor(color);
+	label.textItem.Font = IsValid(uiFont) ? uiFont : GEngine->GetSmallFont();
+}
+
 void APlayerHUD::DrawMinimap()
 {
 	ARealmPlayerController* pc = Cast<ARealmPlayerController>(PlayerOwner);
@@ -106,10 +416,9 @@ void APlayerHUD::DrawMinimap()
 	Canvas->K2_DrawBox(pdp, FVector2D(32.f / 1920.f * Canvas->ClipX, 32.f / 1080.f * Canvas->ClipY));
 
 	//draw other units
-	for (TActorIterator<AGameCharacter> unititr(GetWorld()); unititr; ++unititr)
+	for (AGameCharacter* gc : visibleCharacters)
 	{
-		AGameCharacter* gc = (*unititr);
-		if (gc->IsAlive() && !gc->bHidden) //draw visible and alive units
+		if (IsValid(gc)) //draw visible and alive units
 		{
 			playerHeading = GetUnitHeading(gc);
 
@@ -3,6 +3,7 @@
 #include "GameCharacter.h"
 #include "UnrealNetwork.h"
 #include "RealmPlayerController.h"
+#include "RealmLagCompensation.h"
 
 AProjectile::AProjectile(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
@@ -32,6 +33,9 @@ AProjectile::AProjectile(const FObjectInitializer& objectInitializer)
 	PrimaryActorTick.bCanEverTick = true;
 
 	NetUpdateFrequency = 30.f;
+
+	hitRewindTime = 0.f;
+	lastHitCheckLocation = FVector::ZeroVector;
 }
 
 void AProjectile::BeginPlay()
@@ -72,6 +76,9 @@ void AProjectile::Tick(float DeltaTime)
 			Destroy();
 			return;
 		}
+
+		if (hitRewindTime > 0.f)
+			CheckRewoundHits();
 	}
 	else
 	{
@@ -101,6 +108,56 @@ void AProjectile::InitializeProjectile(const FVector& AimDir, float inDamage, TS
 		movementComponent->HomingTargetComponent = homingTarget->GetRootComponent();
 		movementComponent->bIsHomingProjectile = true;
 	}
+
+	//skill shots from players are checked against where the targets were on the shooter's screen. homing projectiles can't miss
+	URealmLagCompensation* lagCompensation = URealmLagCompensation::Get(GetWorld());
+	if (HasAuthority() && lagCompensation && !movementComponent->bIsHomingProjectile && damageType)
+	{
+		hitRewindTime = lagCompensation->GetRewindTime(projectileSpawner);
+		lastHitCheckLocation = GetActorLocation();
+	}
+}
+
+void AProjectile::CheckRewoundHits()
+{
+	//without the shooter there's nobody to rewind for, go back to plain overlaps
+	URealmLagCompensation* lagCompensation = URealmLagCompensation::Get(GetWorld());
+	if (!lagCompensation || !IsValid(projectileSpawner))
+	{
+		hitRewindTime = 0.f;
+		return;
+	}
+
+	const FVector location = GetActorLocation();
+
+	TArray<FHitResult> hits;
+	lagCompensation->SweepCharacters(this, lastHitCheckLocation, location, collisionComp->GetScaledSphereRadius(), hitRewindTime, hits);
+	lastHitCheckLocation = location;
+
+	//first character along the way takes the hit, same as the overlap would have
+	for (int32 i = 0; i < hits.Num(); i++)
+	{
+		//the rewound spawner is still standing where the projectile was launched from
+		AGameCharacter* gc = Cast<AGameCharacter>(hits[i].GetActor());
+		if (!IsValid(gc) || gc == projectileSpawner)
+			continue;
+
+		ServerProjectileCollision(gc);
+		HitCharacter(gc);
+		return;
+	}
+}
+
+void AProjectile::HitCharacter(AGameCharacter* gc)
+{
+	//play hit sound
+	gc->PlayCharacterSound(hitSound);
+
+	FDamageEvent damageEvent(damageType);
+	//gc->TakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this);
+	gc->CharacterTakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this, realmDamage, damageDesc);
+
+	Destroy();
 }
 
 void AProjectile::OnHit(class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -111,6 +168,10 @@ void AProjectile::OnHit(class AActor* OtherActor, class UPrimitiveComponent* Oth
 		return;
 	}
 
+	//characters are hit in their rewound positions from tick instead
+	if (hitRewindTime > 0.f && Cast<AGameCharacter>(OtherActor))
+		return;
+
 	ServerProjectileCollision(Cast<AGameCharacter>(OtherActor));
 
 	if (damageType == nullptr)
@@ -134,14 +195,7 @@ void AProjectile::OnHit(class AActor* OtherActor, class UPrimitiveComponent* Oth
 		if (!damageType)
 			return;
 
-		//play hit sound
-		gc->PlayCharacterSound(hitSound);
-
-		FDamageEvent damageEvent(damageType);
-		//gc->TakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this);
-		gc->CharacterTakeDamage(damage, damageEvent, projectileSpawner->GetRealmController(), this, realmDamage, damageDesc);
-
-		Destroy();
+		HitCharacter(gc);
 	}
 }
 
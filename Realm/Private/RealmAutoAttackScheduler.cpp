@@ -0,0 +1,69 @@
+#include "Realm.h"
+#include "RealmAutoAttackScheduler.h"
+#include "RealmGameMode.h"
+#include "RealmPlayerController.h"
+#include "GameCharacter.h"
+
+URealmAutoAttackScheduler::URealmAutoAttackScheduler(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	gameOwner = nullptr;
+}
+
+void URealmAutoAttackScheduler::AddAttacker(AGameCharacter* attacker)
+{
+	if (!IsValid(attacker) || attacker->bInAutoAttackSchedule)
+		return;
+
+	attacker->bInAutoAttackSchedule = true;
+	attackers.Add(attacker);
+}
+
+void URealmAutoAttackScheduler::AddPursuer(ARealmPlayerController* pursuer)
+{
+	if (!IsValid(pursuer) || pursuer->bInAutoAttackSchedule)
+		return;
+
+	pursuer->bInAutoAttackSchedule = true;
+	pursuers.Add(pursuer);
+}
+
+void URealmAutoAttackScheduler::UpdateAutoAttacks()
+{
+	UWorld* gameWorld = IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr;
+	if (!gameWorld)
+		return;
+
+	const float currentTime = gameWorld->GetTimeSeconds();
+
+	//attackers can schedule other attackers (killing a target retargets minions), so only step the ones that were here at the start
+	const int32 attackerCount = attackers.Num();
+	for (int32 i = attackerCount - 1; i >= 0; i--)
+	{
+		AGameCharacter* attacker = attackers[i];
+		if (IsValid(attacker) && attacker->UpdateAutoAttack(currentTime))
+			continue;
+
+		if (IsValid(attacker))
+			attacker->bInAutoAttackSchedule = false;
+
+		attackers.RemoveAtSwap(i, 1, false);
+	}
+
+	for (int32 i = pursuers.Num() - 1; i >= 0; i--)
+	{
+		ARealmPlayerController* pursuer = pursuers[i];
+		if (IsValid(pursuer) && pursuer->UpdateAutoAttackPursuit())
+			continue;
+
+		if (IsValid(pursuer))
+			pursuer->bInAutoAttackSchedule = false;
+
+		pursuers.RemoveAtSwap(i, 1, false);
+	}
+}
+
+int32 URealmAutoAttackScheduler::GetAttackerCount() const
+{
+	return attackers.Num();
+}
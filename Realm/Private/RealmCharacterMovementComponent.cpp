@@ -1,11 +1,38 @@
 #include "Realm.h"
 #include "RealmCharacterMovementComponent.h"
 #include "GameCharacter.h"
+#include "RealmLaneAvoidance.h"
+#include "RealmPlayerController.h"
+#include "RealmGroundHeightfield.h"
 
 URealmCharacterMovementComponent::URealmCharacterMovementComponent(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	laneAvoidance = nullptr;
+	avoidanceLane = INDEX_NONE;
+	avoidanceAgent = INDEX_NONE;
+
+	bPredictingMove = false;
+	predictedCommandId = 0;
+	predictedPathIndex = 0;
+	predictionFinishedTime = 0.f;
+	pendingCorrection = FVector::ZeroVector;
+
+	bSimulatingDash = false;
+	simulatedDashEnd = FVector::ZeroVector;
+	simulatedDashSpeed = 0.f;
+
+	maxPredictionError = 250.f;
+	correctionRate = 10.f;
+	maxSavedMoveAge = 1.f;
+}
+
+void URealmCharacterMovementComponent::RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed)
+{
+	if (IsValid(laneAvoidance))
+		Super::RequestDirectMove(laneAvoidance->ApplyAvoidance(avoidanceLane, avoidanceAgent, MoveVelocity), bForceMaxSpeed);
+	else
+		Super::RequestDirectMove(MoveVelocity, bForceMaxSpeed);
 }
 
 void URealmCharacterMovementComponent::InitializeComponent()
@@ -15,6 +42,19 @@ void URealmCharacterMovementComponent::InitializeComponent()
 
 void URealmCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
+	//the prediction and simulated dashes place the capsule themselves, simulating the replicated velocity would only fight them
+	if (bSimulatingDash)
+	{
+		TickSimulatedDash(DeltaTime);
+		return;
+	}
+
+	if (bPredictingMove)
+	{
+		TickPredictedMove(DeltaTime);
+		return;
+	}
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	if (bCharacterDashing)
@@ -22,7 +62,7 @@ void URealmCharacterMovementComponent::TickComponent(float DeltaTime, enum ELeve
 		if ((GetCharacterOwner()->GetActorLocation() - targetDashLocation).IsNearlyZero(15.f))
 			EndDash();
 		else
-			GetCharacterOwner()->SetActorLocation(FMath::VInterpConstantTo(GetCharacterOwner()->GetActorLocation(), targetDashLocation, DeltaTime, 7100.f*flySpeedScale));
+			GetCharacterOwner()->SetActorLocation(FMath::VInterpConstantTo(GetCharacterOwner()->GetActorLocation(), targetDashLocation, DeltaTime, DASH_SPEED*flySpeedScale));
 	}
 }
 
@@ -98,3 +138,244 @@ void URealmCharacterMovementComponent::ClearMovementIgnorance()
 	SetMovementMode(MOVE_Walking);
 }
 
+void URealmCharacterMovementComponent::StartPredictedMove(const FVector& targetLocation, int32 commandId)
+{
+	if (!IsValid(CharacterOwner) || !UpdatedComponent)
+		return;
+
+	const FVector start = UpdatedComponent->GetComponentLocation();
+
+	predictedPath.Reset();
+
+	//clients without navigation data walk straight at the target and let the server's path correct them
+	UNavigationPath* path = UNavigationSystem::FindPathToLocationSynchronously(GetWorld(), start, targetLocation, CharacterOwner);
+	if (path && path->IsValid() && path->PathPoints.Num() > 1)
+	{
+		for (int32 i = 1; i < path->PathPoints.Num(); i++)
+			predictedPath.Add(path->PathPoints[i]);
+	}
+	else
+		predictedPath.Add(targetLocation);
+
+	predictedPathIndex = 0;
+	predictedCommandId = commandId;
+	predictionFinishedTime = 0.f;
+
+	//a new command while already predicting carries on from the same history
+	if (!bPredictingMove)
+	{
+		savedMoves.Reset();
+		pendingCorrection = FVector::ZeroVector;
+		savedMoves.Add(FRealmSavedMove(GetWorld()->GetTimeSeconds(), start));
+	}
+
+	bPredictingMove = true;
+}
+
+void URealmCharacterMovementComponent::StopPredictedMove()
+{
+	bPredictingMove = false;
+	predictedPath.Reset();
+	savedMoves.Reset();
+	pendingCorrection = FVector::ZeroVector;
+	predictionFinishedTime = 0.f;
+}
+
+void URealmCharacterMovementComponent::TickPredictedMove(float DeltaTime)
+{
+	AGameCharacter* gc = Cast<AGameCharacter>(CharacterOwner);
+	if (!IsValid(gc) || !gc->IsAlive() || !UpdatedComponent || DeltaTime <= 0.f)
+	{
+		StopPredictedMove();
+		return;
+	}
+
+	const float currentTime = GetWorld()->GetTimeSeconds();
+
+	//walk the path at the hero's replicated move speed
+	FVector delta = FVector::ZeroVector;
+	if (predictionFinishedTime <= 0.f)
+	{
+		const FVector location = UpdatedComponent->GetComponentLocation();
+		float moveDistance = gc->GetCurrentValueForStat(EStat::ES_Move) * DeltaTime;
+
+		while (moveDistance > 0.f && predictedPathIndex < predictedPath.Num())
+		{
+			FVector toPoint = predictedPath[predictedPathIndex] - (location + delta);
+			toPoint.Z = 0.f;
+
+			const float distance = toPoint.Size();
+			if (distance <= moveDistance)
+			{
+				delta += toPoint;
+				moveDistance -= distance;
+				predictedPathIndex++;
+			}
+			else
+			{
+				delta += toPoint * (moveDistance / distance);
+				moveDistance = 0.f;
+			}
+		}
+
+		if (predictedPathIndex >= predictedPath.Num())
+			predictionFinishedTime = currentTime;
+	}
+
+	//velocity drives the run animation
+	Velocity = delta / DeltaTime;
+	MovePredicted(delta, DeltaTime);
+
+	//blend in a share of what the server says we got wrong
+	if (!pendingCorrection.IsNearlyZero())
+	{
+		const FVector correction = pendingCorrection * FMath::Min(1.f, correctionRate * DeltaTime);
+		pendingCorrection -= correction;
+		UpdatedComponent->SetWorldLocation(UpdatedComponent->GetComponentLocation() + correction);
+	}
+
+	savedMoves.Add(FRealmSavedMove(currentTime, UpdatedComponent->GetComponentLocation()));
+
+	int32 expired = 0;
+	while (expired < savedMoves.Num() - 1 && currentTime - savedMoves[expired].timestamp > maxSavedMoveAge)
+		expired++;
+
+	if (expired > 0)
+		savedMoves.RemoveAt(0, expired, false);
+
+	//the path is walked and the server has had time to finish it too, the replicated movement can take over again
+	if (predictionFinishedTime > 0.f && currentTime - predictionFinishedTime > GetRoundTripTime() + 0.25f && pendingCorrection.SizeSquared() < 1.f)
+	{
+		Velocity = FVector::ZeroVector;
+		StopPredictedMove();
+	}
+}
+
+void URealmCharacterMovementComponent::MovePredicted(const FVector& delta, float DeltaTime)
+{
+	if (delta.IsNearlyZero())
+		return;
+
+	FRotator rotation = UpdatedComponent->GetComponentRotation();
+	FRotator facing = delta.Rotation();
+	facing.Pitch = 0.f;
+	facing.Roll = 0.f;
+	rotation = FMath::RInterpTo(rotation, facing, DeltaTime, 10.f);
+
+	FHitResult hit;
+	SafeMoveUpdatedComponent(delta, rotation, true, hit);
+	if (hit.IsValidBlockingHit())
+		SlideAlongSurface(delta, 1.f - hit.Time, hit.Normal, hit, false);
+
+	//keep the capsule on the ground the same way the server's walking does
+	const FVector location = UpdatedComponent->GetComponentLocation();
+	const FVector ground = FRealmGroundHeightfield::FindGroundBeneathPoint(GetWorld(), location, 500.f);
+	if (ground != location)
+		UpdatedComponent->SetWorldLocation(FVector(location.X, location.Y, ground.Z + CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight()));
+}
+
+float URealmCharacterMovementComponent::GetRoundTripTime() const
+{
+	APlayerController* pc = GetWorld()->GetFirstPlayerController();
+	if (IsValid(pc) && IsValid(pc->PlayerState))
+		return pc->PlayerState->ExactPing * 0.001f;
+
+	return 0.f;
+}
+
+bool URealmCharacterMovementComponent::GetSavedLocationAtTime(float time, FVector& outLocation) const
+{
+	if (savedMoves.Num() == 0 || time < savedMoves[0].timestamp)
+		return false;
+
+	for (int32 i = savedMoves.Num() - 1; i >= 0; i--)
+	{
+		if (savedMoves[i].timestamp > time)
+			continue;
+
+		if (i == savedMoves.Num() - 1)
+			outLocation = savedMoves[i].location;
+		else
+		{
+			const FRealmSavedMove& before = savedMoves[i];
+			const FRealmSavedMove& after = savedMoves[i + 1];
+			const float alpha = after.timestamp > before.timestamp ? (time - before.timestamp) / (after.timestamp - before.timestamp) : 0.f;
+			outLocation = FMath::Lerp(before.location, after.location, alpha);
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+bool URealmCharacterMovementComponent::ReconcileServerLocation(const FVector& serverLocation)
+{
+	if (!bPredictingMove)
+		return false;
+
+	//until the server has run our command, what it sends is from before the click
+	ARealmPlayerController* pc = Cast<ARealmPlayerController>(GetWorld()->GetFirstPlayerController());
+	if (!IsValid(pc) || pc->GetAcknowledgedCommand() < predictedCommandId)
+		return true;
+
+	//the server started the command half a round trip after us and this location took another half to get here,
+	//so it lines up with where we were a whole round trip ago
+	FVector predictedLocation;
+	if (!GetSavedLocationAtTime(GetWorld()->GetTimeSeconds() - GetRoundTripTime(), predictedLocation))
+		return true;
+
+	FVector error = serverLocation - predictedLocation;
+	error.Z = 0.f;
+
+	//the server went somewhere else entirely (blocked, stunned, pulled), stop guessing
+	if (error.SizeSquared() > FMath::Square(maxPredictionError))
+	{
+		StopPredictedMove();
+		return false;
+	}
+
+	//blend the difference in, and move the history with it so the same error isn't corrected twice
+	pendingCorrection += error;
+	for (FRealmSavedMove& move : savedMoves)
+		move.location += error;
+
+	return true;
+}
+
+void URealmCharacterMovementComponent::SimulateDash(const FVector& startLocation, const FVector& endLocation, float speed, float elapsed)
+{
+	if (!UpdatedComponent || speed <= 0.f)
+		return;
+
+	StopPredictedMove();
+
+	simulatedDashEnd = endLocation;
+	simulatedDashEnd.Z = startLocation.Z;
+	simulatedDashSpeed = speed;
+	bSimulatingDash = true;
+
+	//catch up to where the server has already got to
+	UpdatedComponent->SetWorldLocation(FMath::VInterpConstantTo(startLocation, simulatedDashEnd, FMath::Max(elapsed, 0.f), speed));
+}
+
+void URealmCharacterMovementComponent::TickSimulatedDash(float DeltaTime)
+{
+	if (!UpdatedComponent)
+	{
+		bSimulatingDash = false;
+		return;
+	}
+
+	const FVector location = UpdatedComponent->GetComponentLocation();
+	const FVector newLocation = FMath::VInterpConstantTo(location, simulatedDashEnd, DeltaTime, simulatedDashSpeed);
+
+	UpdatedComponent->SetWorldLocation(newLocation);
+	Velocity = DeltaTime > 0.f ? (newLocation - location) / DeltaTime : FVector::ZeroVector;
+
+	if ((newLocation - simulatedDashEnd).IsNearlyZero(15.f))
+	{
+		Velocity = FVector::ZeroVector;
+		bSimulatingDash = false;
+	}
+}
@@ -0,0 +1,132 @@
+#include "Realm.h"
+#include "RealmClientSignificanceManager.h"
+#include "RealmPlayerController.h"
+#include "GameCharacter.h"
+#include "PlayerCharacter.h"
+
+URealmClientSignificanceManager::URealmClientSignificanceManager(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	playerOwner = nullptr;
+
+	highScreenSize = 0.12f;
+	lowScreenSize = 0.04f;
+	lowAnimTickInterval = 0.1f;
+	updateInterval = 0.25f;
+
+	for (int32 i = 0; i < (uint8)ERealmSignificance::RS_MAX; i++)
+		tierCounts[i] = 0;
+}
+
+void URealmClientSignificanceManager::StartUpdatingSignificance()
+{
+	if (IsValid(playerOwner))
+		playerOwner->GetWorldTimerManager().SetTimer(significanceTimer, this, &URealmClientSignificanceManager::UpdateSignificance, updateInterval, true);
+}
+
+void URealmClientSignificanceManager::UpdateSignificance()
+{
+	UWorld* gameWorld = IsValid(playerOwner) ? playerOwner->GetWorld() : nullptr;
+	if (!gameWorld || !playerOwner->PlayerCameraManager)
+		return;
+
+	const FVector cameraLocation = playerOwner->PlayerCameraManager->GetCameraLocation();
+	const float tanHalfFOV = FMath::Tan(FMath::DegreesToRadians(playerOwner->PlayerCameraManager->GetFOVAngle() * 0.5f));
+	AGameCharacter* localHero = playerOwner->GetPlayerCharacter();
+
+	for (int32 i = 0; i < (uint8)ERealmSignificance::RS_MAX; i++)
+		tierCounts[i] = 0;
+
+	for (TActorIterator<AGameCharacter> itr(gameWorld); itr; ++itr)
+	{
+		AGameCharacter* character = *itr;
+		if (!IsValid(character) || !IsValid(character->GetMesh()))
+			continue;
+
+		ERealmSignificance tier = ERealmSignificance::RS_High;
+		if (!IsLocalCombatant(character, localHero))
+		{
+			//fogged characters aren't drawn, they only need to keep their pose roughly current for when they're revealed
+			if (character->bHidden)
+				tier = ERealmSignificance::RS_Low;
+			else
+			{
+				const float screenSize = GetScreenSize(character, cameraLocation, tanHalfFOV);
+				if (screenSize >= highScreenSize)
+					tier = ERealmSignificance::RS_High;
+				else if (screenSize >= lowScreenSize)
+					tier = ERealmSignificance::RS_Medium;
+				else
+					tier = ERealmSignificance::RS_Low;
+			}
+		}
+
+		ERealmSignificance* currentTier = characterTiers.Find(character);
+		if (!currentTier || *currentTier != tier)
+		{
+			ApplyTier(character, tier);
+			characterTiers.Add(character, tier);
+		}
+
+		tierCounts[(uint8)tier]++;
+	}
+
+	//forget characters that have been destroyed
+	for (auto itr = characterTiers.CreateIterator(); itr; ++itr)
+	{
+		if (!itr.Key().IsValid())
+			itr.RemoveCurrent();
+	}
+}
+
+bool URealmClientSignificanceManager::IsLocalCombatant(AGameCharacter* character, AGameCharacter* localHero) const
+{
+	if (!IsValid(localHero))
+		return false;
+
+	return character == localHero || character == localHero->GetCurrentTarget() || character == playerOwner->infoTarget ||
+		character->GetCurrentTarget() == localHero;
+}
+
+float URealmClientSignificanceManager::GetScreenSize(AGameCharacter* character, const FVector& cameraLocation, float tanHalfFOV) const
+{
+	const FBoxSphereBounds& bounds = character->GetMesh()->Bounds;
+	const float distance = FVector::Dist(bounds.Origin, cameraLocation);
+
+	if (distance <= bounds.SphereRadius || tanHalfFOV <= 0.f)
+		return 1.f;
+
+	return bounds.SphereRadius / (distance * tanHalfFOV);
+}
+
+void URealmClientSignificanceManager::ApplyTier(AGameCharacter* character, ERealmSignificance tier)
+{
+	USkeletalMeshComponent* mesh = character->GetMesh();
+
+	switch (tier)
+	{
+	case ERealmSignificance::RS_High:
+		mesh->bEnableUpdateRateOptimizations = false;
+		mesh->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::AlwaysTickPose;
+		mesh->PrimaryComponentTick.TickInterval = 0.f;
+		break;
+	case ERealmSignificance::RS_Medium:
+		mesh->bEnableUpdateRateOptimizations = true;
+		mesh->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered;
+		mesh->PrimaryComponentTick.TickInterval = 0.f;
+		break;
+	default:
+		mesh->bEnableUpdateRateOptimizations = true;
+		mesh->MeshComponentUpdateFlag = EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered;
+		mesh->PrimaryComponentTick.TickInterval = lowAnimTickInterval;
+		break;
+	}
+}
+
+int32 URealmClientSignificanceManager::GetTierCount(ERealmSignificance tier) const
+{
+	if ((uint8)tier >= (uint8)ERealmSignificance::RS_MAX)
+		return 0;
+
+	return tierCounts[(uint8)tier];
+}
@@ -0,0 +1,75 @@
+#include "Realm.h"
+#include "RealmCosmeticChannel.h"
+#include "RealmGameMode.h"
+#include "RealmPlayerController.h"
+#include "PlayerCharacter.h"
+
+URealmCosmeticChannel::URealmCosmeticChannel(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	gameOwner = nullptr;
+}
+
+void URealmCosmeticChannel::QueueEvent(const FRealmCosmeticEvent& cosmeticEvent)
+{
+	if (IsValid(cosmeticEvent.source) && cosmeticEvent.asset)
+		pendingEvents.Add(cosmeticEvent);
+}
+
+void URealmCosmeticChannel::FlushEvents()
+{
+	UWorld* gameWorld = IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr;
+	if (!gameWorld || pendingEvents.Num() == 0)
+		return;
+
+	TArray<FRealmCosmeticEvent> batch;
+	batch.Reserve(COSMETIC_BATCH_SIZE);
+
+	for (FConstPlayerControllerIterator Iterator = gameWorld->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		ARealmPlayerController* pc = Cast<ARealmPlayerController>(*Iterator);
+		if (!IsValid(pc))
+			continue;
+
+		batch.Reset();
+		for (const FRealmCosmeticEvent& cosmeticEvent : pendingEvents)
+		{
+			if (!CanPlayerSeeEvent(pc, cosmeticEvent))
+				continue;
+
+			batch.Add(cosmeticEvent);
+			if (batch.Num() == COSMETIC_BATCH_SIZE)
+			{
+				pc->ClientReceiveCosmeticEvents(batch);
+				batch.Reset();
+			}
+		}
+
+		if (batch.Num() > 0)
+			pc->ClientReceiveCosmeticEvents(batch);
+	}
+
+	pendingEvents.Reset();
+}
+
+bool URealmCosmeticChannel::CanPlayerSeeEvent(ARealmPlayerController* pc, const FRealmCosmeticEvent& cosmeticEvent) const
+{
+	AGameCharacter* source = cosmeticEvent.source;
+	if (!IsValid(source))
+		return false;
+
+	//the character doesn't exist on a connection it isn't relevant to
+	AActor* viewTarget = pc->GetViewTarget();
+	if (IsValid(viewTarget) && !source->IsNetRelevantFor(pc, viewTarget, viewTarget->GetActorLocation()))
+		return false;
+
+	//spectators and players still picking characters see everything
+	APlayerCharacter* playerCharacter = pc->GetPlayerCharacter();
+	if (!IsValid(playerCharacter))
+		return true;
+
+	if (source == playerCharacter || source->GetTeamIndex() == playerCharacter->GetTeamIndex())
+		return true;
+
+	return pc->sightList.Contains(source);
+}
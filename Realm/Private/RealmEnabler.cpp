@@ -18,50 +18,47 @@ void ARealmEnabler::PlayerOpenedStore(ARealmPlayerController* pc)
 	
 }
 
-void ARealmEnabler::BeginPlay()
+float ARealmEnabler::GetWatchedRange() const
 {
-	Super::BeginPlay();
+	return auraRange;
+}
 
-	if (Role == ROLE_Authority)
-	{
-		FTimerHandle h;
-		GetWorldTimerManager().SetTimer(h, this, &ARealmEnabler::OnTargetsUpdate, 0.25f, true);
-	}
+bool ARealmEnabler::ShouldWatchUnit(AGameCharacter* unit) const
+{
+	return unit->IsA(APlayerCharacter::StaticClass()) && unit->GetTeamIndex() == GetTeamIndex();
 }
 
-void ARealmEnabler::OnTargetsUpdate()
+void ARealmEnabler::OnUnitLeftRange(AGameCharacter* unit)
 {
-	
-	for (TActorIterator<APlayerCharacter> plyitr(GetWorld()); plyitr; ++plyitr)
-	{
-		APlayerCharacter* pc = (*plyitr);
-		if (!IsValid(pc) || !pc->IsAlive() || pc->GetTeamIndex() != GetTeamIndex())
-			continue;
+	//destroyed players are still removed, they just don't have an effect left to take off
+	APlayerCharacter* pc = Cast<APlayerCharacter>(unit);
+	if (protectedPlayers.Remove(pc) > 0 && IsValid(pc) && IsValid(pc->GetStatsManager()))
+		EnablerEffectFinished(pc);
+}
 
-		float distanceSq = (pc->GetActorLocation() - GetActorLocation()).SizeSquared2D();
-		if (distanceSq > FMath::Square(auraRange))
-		{
-			if (IsValid(pc->GetStatsManager()) && protectedPlayers.Contains(pc) && protectedPlayers.Remove(pc) > 0)
-				EnablerEffectFinished(pc);
-		}
-		else if (!protectedPlayers.Contains(pc) && protectedPlayers.AddUnique(pc) >= 0)
-		{
-			enablerAuraEffect = GetWorld()->SpawnActor<AEffect>(AEffect::StaticClass());
+void ARealmEnabler::OnUnitEnteredRange(AGameCharacter* unit)
+{
+	APlayerCharacter* pc = Cast<APlayerCharacter>(unit);
+	if (!IsValid(pc) || !IsValid(pc->GetStatsManager()))
+		return;
 
-			//effect descriptions
-			enablerAuraEffect->uiName = LOCTEXT("enablereffect", "Enabler Protection Aura");
-			enablerAuraEffect->description = LOCTEXT("enablereffectdesc", "This unit is under protection from their Enabler and has increased Health and Flare regeneration.");
-			enablerAuraEffect->keyName = "enablerprotection";
-			enablerAuraEffect->bCanBeInflictedMultipleTimes = false;
+	if (!protectedPlayers.Contains(pc) && protectedPlayers.AddUnique(pc) >= 0)
+	{
+		enablerAuraEffect = GetWorld()->SpawnActor<AEffect>(AEffect::StaticClass());
 
-			//effect stat changes
-			enablerAuraEffect->stats.AddUnique(EStat::ES_HPRegen);
-			enablerAuraEffect->stats.AddUnique(EStat::ES_FlareRegen);
-			enablerAuraEffect->amounts.Add(50.f);
-			enablerAuraEffect->amounts.Add(50.f);
+		//effect descriptions
+		enablerAuraEffect->uiName = LOCTEXT("enablereffect", "Enabler Protection Aura");
+		enablerAuraEffect->description = LOCTEXT("enablereffectdesc", "This unit is under protection from their Enabler and has increased Health and Flare regeneration.");
+		enablerAuraEffect->keyName = "enablerprotection";
+		enablerAuraEffect->bCanBeInflictedMultipleTimes = false;
 
-			pc->GetStatsManager()->AddCreatedEffect(enablerAuraEffect);
-		}
+		//effect stat changes
+		enablerAuraEffect->stats.AddUnique(EStat::ES_HPRegen);
+		enablerAuraEffect->stats.AddUnique(EStat::ES_FlareRegen);
+		enablerAuraEffect->amounts.Add(50.f);
+		enablerAuraEffect->amounts.Add(50.f);
+
+		pc->GetStatsManager()->AddCreatedEffect(enablerAuraEffect);
 	}
 }
 
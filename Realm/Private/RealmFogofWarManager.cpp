@@ -4,11 +4,12 @@
 #include "PlayerCharacter.h"
 #include "RealmPlayerController.h"
 #include "RealmGameMode.h"
+#include "ParallelFor.h"
 
 URealmFogofWarManager::URealmFogofWarManager(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	visibilityWorker = nullptr;
 }
 
 void URealmFogofWarManager::StartCalculatingVisibility()
@@ -18,24 +19,59 @@ void URealmFogofWarManager::StartCalculatingVisibility()
 	else if (IsValid(gameOwner))
 		gameOwner->GetWorldTimerManager().SetTimer(visibilityTimer, this, &URealmFogofWarManager::CalculateTeamVisibility, (0.15f), true);
 
-	FGameVisibilityWorker::WorkerInit(this);
+	if (!visibilityWorker)
+		visibilityWorker = new FGameVisibilityWorker();
 }
 
 void URealmFogofWarManager::CalculateTeamVisibility()
 {
 	UWorld* gameWorld = IsValid(playerOwner) ? playerOwner->GetWorld() : gameOwner->GetWorld();
 
-	if (availableUnits.Num() <= 0)
+	if (!visibilityWorker || !gameWorld)
+		return;
+
+	//a pass that's still running keeps going, its results are applied the moment it finishes
+	if (visibilityWorker->IsBusy())
+		return;
+
+	//a finished pass whose game thread task hasn't run yet would be overwritten by the next one
+	ApplyVisibilityResults();
+
+	availableUnits.Reset();
+	for (TActorIterator<AGameCharacter> itr(gameWorld); itr; ++itr)
+		availableUnits.AddUnique(*itr);
+
+	visibilityWorker->LaunchPass(availableUnits, enemySightLists.Num());
+
+	FGraphEventRef passCompletion = visibilityWorker->GetPassCompletion();
+	if (!passCompletion.GetReference())
+		return;
+
+	//hand the results over on the game thread as soon as the pass's fence fires instead of waiting for the next timer tick
+	FGraphEventArray prerequisites;
+	prerequisites.Add(passCompletion);
+
+	TWeakObjectPtr<URealmFogofWarManager> weakThis(this);
+	FFunctionGraphTask::CreateAndDispatchWhenReady([weakThis]()
 	{
-		for (TActorIterator<AGameCharacter> itr(gameWorld); itr; ++itr)
-			availableUnits.AddUnique(*itr);
-	}
+		if (weakThis.IsValid())
+			weakThis->ApplyVisibilityResults();
+	}, TStatId(), &prerequisites, ENamedThreads::GameThread);
+}
+
+void URealmFogofWarManager::ApplyVisibilityResults()
+{
+	UWorld* gameWorld = IsValid(playerOwner) ? playerOwner->GetWorld() : (IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr);
+
+	if (!visibilityWorker || !gameWorld || !visibilityWorker->TakeResults(enemySightLists))
+		return;
 
 	//update the players with their new sight lists
 	for (FConstPlayerControllerIterator Iterator = gameWorld->GetPlayerControllerIterator(); Iterator; ++Iterator)
 	{
 		ARealmPlayerController* pc = Cast<ARealmPlayerController>(*Iterator);
-		if (IsValid(pc) && IsValid(pc->GetPlayerCharacter()) && enemySightLists[pc->GetPlayerCharacter()->GetTeamIndex()].sightList.Num() > 0)
+		if (IsValid(pc) && IsValid(pc->GetPlayerCharacter()) && enemySightLists.IsValidIndex(pc->GetPlayerCharacter()->GetTeamIndex()) &&
+			enemySightLists[pc->GetPlayerCharacter()->GetTeamIndex()].sightList.Num() > 0)
 			pc->sightList = enemySightLists[pc->GetPlayerCharacter()->GetTeamIndex()].sightList;
 	}
 }
@@ -60,7 +96,7 @@ void URealmFogofWarManager::AddPlayerToManager(ARealmPlayerController* newPlayer
 
 bool URealmFogofWarManager::CanUnitSeeOther(AGameCharacter* originUnit, AGameCharacter* testUnit) const
 {
-	if (!IsValid(originUnit) || !IsValid(testUnit))
+	if (!IsValid(originUnit) || !IsValid(testUnit) || !enemySightLists.IsValidIndex(originUnit->GetTeamIndex()))
 		return false;
 
 	return enemySightLists[originUnit->GetTeamIndex()].sightList.Contains(testUnit);
@@ -70,96 +106,116 @@ void URealmFogofWarManager::BeginDestroy()
 {
 	Super::BeginDestroy();
 
-	FGameVisibilityWorker::Shutdown();
+	//only stop this manager's work, other worlds in the process keep running theirs
+	if (visibilityWorker)
+	{
+		visibilityWorker->EnsureCompletion();
+		delete visibilityWorker;
+		visibilityWorker = nullptr;
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------------------------------------------
-FGameVisibilityWorker* FGameVisibilityWorker::runnable = nullptr;
-
-FGameVisibilityWorker::FGameVisibilityWorker(URealmFogofWarManager* inFoW, TArray<FTeamSightList>& sightLists)
-: fogOfWar(inFoW)
+FGameVisibilityWorker::FGameVisibilityWorker()
+: bHasResults(false)
 {
-	enemySightLists = &sightLists;
-
-	Thread = FRunnableThread::Create(this, TEXT("FGameVisibilityWorker"), 0, TPri_BelowNormal);
 }
 
 FGameVisibilityWorker::~FGameVisibilityWorker()
 {
-	delete Thread;
-	Thread = nullptr;
+	EnsureCompletion();
 }
 
-bool FGameVisibilityWorker::Init()
+void FGameVisibilityWorker::LaunchPass(const TArray<AGameCharacter*>& inUnits, int32 sightListCount)
 {
-	return true;
-}
+	if (IsBusy())
+		return;
 
-uint32 FGameVisibilityWorker::Run()
-{
-	while (stopTaskCounter.GetValue() == 0)
-	{
-		CalculateVisibilities(); //actually calculate visibilities
-		FPlatformProcess::Sleep(0.05f); //sleep for a period of time to let the game world update
-	}
+	//don't calculate if we weren't given available units and just wait until we do
+	if (inUnits.Num() <= 0)
+		return;
 
-	return 0;
-}
+	units = inUnits;
+	sightLists.SetNum(sightListCount);
 
-void FGameVisibilityWorker::Stop()
-{
-	stopTaskCounter.Increment();
+	passCompletion = FFunctionGraphTask::CreateAndDispatchWhenReady([this]()
+	{
+		CalculateVisibilities();
+		bHasResults = true;
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
 }
 
-FGameVisibilityWorker* FGameVisibilityWorker::WorkerInit(URealmFogofWarManager* inFoW)
+bool FGameVisibilityWorker::TakeResults(TArray<FTeamSightList>& outSightLists)
 {
-	if (!runnable && FPlatformProcess::SupportsMultithreading() && inFoW)
-		runnable = new FGameVisibilityWorker(inFoW, inFoW->enemySightLists);
+	if (IsBusy() || !bHasResults)
+		return false;
 
-	return runnable;
+	Swap(outSightLists, sightLists);
+	bHasResults = false;
+	return true;
 }
 
 void FGameVisibilityWorker::EnsureCompletion()
 {
-	Stop();
-	Thread->WaitForCompletion();
+	if (passCompletion.GetReference() && !passCompletion->IsComplete())
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(passCompletion);
+
+	passCompletion = nullptr;
 }
 
-void FGameVisibilityWorker::Shutdown()
+void FGameVisibilityWorker::CalculateVisibilities()
 {
-	if (runnable)
+	const int32 chunkCount = FMath::DivideAndRoundUp(units.Num(), ObserversPerChunk);
+
+	//every chunk gets its own lists so the workers never write to the same array
+	chunkSightLists.SetNum(chunkCount);
+	for (TArray<FTeamSightList>& chunkLists : chunkSightLists)
 	{
-		runnable->EnsureCompletion();
-		delete runnable;
-		runnable = nullptr;
+		chunkLists.SetNum(sightLists.Num());
+		for (FTeamSightList& list : chunkLists)
+			list.sightList.Reset();
 	}
-}
 
-void FGameVisibilityWorker::CalculateVisibilities()
-{
-	if (!IsValid(fogOfWar) || !fogOfWar->IsValidLowLevelFast() || (!IsValid(fogOfWar->playerOwner) && !IsValid(fogOfWar->gameOwner)))
-		return;
+	ParallelFor(chunkCount, [this](int32 chunk)
+	{
+		TArray<FTeamSightList>& chunkLists = chunkSightLists[chunk];
 
-	//don't calculate if we weren't given available units and just wait until we do
-	if (fogOfWar->availableUnits.Num() <= 0)
-		return;
+		const int32 last = FMath::Min((chunk + 1) * ObserversPerChunk, units.Num());
+		for (int32 i = chunk * ObserversPerChunk; i < last; i++)
+		{
+			AGameCharacter* gc = units[i];
 
-	UWorld* gameWorld = IsValid(fogOfWar->playerOwner) ? fogOfWar->playerOwner->GetWorld() : fogOfWar->gameOwner->GetWorld();
+			//get their sight data if they're alive
+			if (IsValid(gc) && gc->IsAlive() && chunkLists.IsValidIndex(gc->GetTeamIndex()))
+				gc->CalculateVisibility(chunkLists[gc->GetTeamIndex()].sightList, units);
+		}
+	});
 
-	if (!gameWorld)
-		return;
+	MergeChunkSightLists();
+	units.Reset();
+}
 
-	//clear enemy sight lists
-	for (int32 list = 0; list < enemySightLists->Num(); list++)
-		(*enemySightLists)[list].sightList.Empty();
+void FGameVisibilityWorker::MergeChunkSightLists()
+{
+	TSet<AGameCharacter*> seen;
 
-	for (AGameCharacter* gc : fogOfWar->availableUnits)
+	for (int32 list = 0; list < sightLists.Num(); list++)
 	{
-		//get their sight data if they're alive
-		if (gc->IsAlive())
-			gc->CalculateVisibility((*enemySightLists)[gc->GetTeamIndex()].sightList, fogOfWar->availableUnits);
+		TArray<AGameCharacter*>& merged = sightLists[list].sightList;
+		merged.Reset();
+		seen.Reset();
+
+		//several observers on a team usually see the same units
+		for (const TArray<FTeamSightList>& chunkLists : chunkSightLists)
+		{
+			for (AGameCharacter* gc : chunkLists[list].sightList)
+			{
+				bool bAlreadySeen = false;
+				seen.Add(gc, &bAlreadySeen);
+				if (!bAlreadySeen)
+					merged.Add(gc);
+			}
+		}
 	}
-
-	fogOfWar->availableUnits.Empty();
-}
\ No newline at end of file
+}
@@ -5,6 +5,15 @@ ARealmForestMinionAI::ARealmForestMinionAI(const FObjectInitializer& objectIniti
 : Super(objectInitializer)
 {
 	aggroDistance = 1000.f;
+
+	bUsesSignificance = true;
+}
+
+void ARealmForestMinionAI::OnSignificanceChanged(ERealmSignificance oldSignificance)
+{
+	Super::OnSignificanceChanged(oldSignificance);
+
+	RescaleRepeatingTimer(reevalTimer, this, &ARealmForestMinionAI::ReevaluateTargets, SignificanceReevaluationScale[(uint8)oldSignificance]);
 }
 
 void ARealmForestMinionAI::Possess(APawn* InPawn)
@@ -30,7 +39,7 @@ void ARealmForestMinionAI::CharacterTookDamage(AGameCharacter* damageCauser)
 		minionCharacter->SetCurrentTarget(damageCauser);
 		minionCharacter->StartAutoAttack();
 
-		GetWorldTimerManager().SetTimer(reevalTimer, this, &ARealmForestMinionAI::ReevaluateTargets, 0.8f, true);
+		GetWorldTimerManager().SetTimer(reevalTimer, this, &ARealmForestMinionAI::ReevaluateTargets, 0.8f * GetReevaluationScale(), true);
 	}
 }
 
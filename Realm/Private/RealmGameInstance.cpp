@@ -1,361 +1,345 @@
 #include "Realm.h"
 #include "RealmGameInstance.h"
-#include <string>
 #include "RealmMainMenu.h"
+#include "RealmGameMode.h"
+#include "PlayerCharacter.h"
+#include "Mod.h"
+#include "RealmRaider.h"
+
+/* hosts of the lobby servers */
+static const FString LOBBY_HOST = TEXT("realmmythos.ddns.net");
+static const FString GAME_SERVER_HOST = TEXT("mythosrealm.ddns.net");
+
+/* points the lobby connections somewhere else, e.g. 127.0.0.1 with realm.LobbyStandIn.Start running */
+static TAutoConsoleVariable<FString> CVarLobbyHostOverride(TEXT("realm.LobbyHost"), TEXT(""), TEXT("Host to use for the login and multiplayer servers instead of the live one. Empty uses the live servers."));
+
+static FString GetLobbyHost()
+{
+	const FString hostOverride = CVarLobbyHostOverride.GetValueOnGameThread();
+	return hostOverride.IsEmpty() ? LOBBY_HOST : hostOverride;
+}
 
 URealmGameInstance::URealmGameInstance(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	
+	loginSocketThread = nullptr;
+	multiplayerSocketThread = nullptr;
+	nextCorrelationId = 1;
+	bLoginSocketWasConnected = false;
+	bMultiplayerSocketWasConnected = false;
+
+	bRecycleServer = false;
+	recycleStartTime = 0.0;
+	coldStartReadyTime = 0.f;
+	averageWarmReadyTime = 0.f;
+	warmRecycleCount = 0;
+
+	//dispatch table for everything the lobby servers can send us
+	for (int32 i = 0; i < LOBBY_HANDLER_COUNT; i++)
+		lobbyHandlers[i] = nullptr;
+
+	lobbyHandlers[(uint8)ELobbyMessage::LoginSuccess] = &URealmGameInstance::OnLoginSuccess;
+	lobbyHandlers[(uint8)ELobbyMessage::LoginFailure] = &URealmGameInstance::OnLoginFailure;
+	lobbyHandlers[(uint8)ELobbyMessage::CreateLoginSuccess] = &URealmGameInstance::OnCreateLoginSuccess;
+	lobbyHandlers[(uint8)ELobbyMessage::CreateLoginFailure] = &URealmGameInstance::OnCreateLoginFailure;
+	lobbyHandlers[(uint8)ELobbyMessage::UpdateInfo] = &URealmGameInstance::OnUpdateInfo;
+	lobbyHandlers[(uint8)ELobbyMessage::JoinedQueueSuccessfully] = &URealmGameInstance::OnJoinedQueueSuccessfully;
+	lobbyHandlers[(uint8)ELobbyMessage::JoinedQueueFailed] = &URealmGameInstance::OnJoinedQueueFailed;
+	lobbyHandlers[(uint8)ELobbyMessage::FoundMatch] = &URealmGameInstance::OnFoundMatch;
+	lobbyHandlers[(uint8)ELobbyMessage::FoundMatchConfirmed] = &URealmGameInstance::OnFoundMatchConfirmed;
+	lobbyHandlers[(uint8)ELobbyMessage::MatchConfirmFailed] = &URealmGameInstance::OnMatchConfirmFailed;
 }
 
 URealmGameInstance::~URealmGameInstance()
 {
 	if (loginSocketThread)
+	{
 		loginSocketThread->EnsureCompletion();
+		delete loginSocketThread;
+		loginSocketThread = nullptr;
+	}
 
 	if (multiplayerSocketThread)
+	{
 		multiplayerSocketThread->EnsureCompletion();
+		delete multiplayerSocketThread;
+		multiplayerSocketThread = nullptr;
+	}
 }
 
-FString URealmGameInstance::StringFromBinaryArray(const TArray<uint8>& BinaryArray)
+void URealmGameInstance::Init()
 {
-	//Create a string from a byte array!
-	std::string cstr(reinterpret_cast<const char*>(BinaryArray.GetData()), BinaryArray.Num());
-	return FString(cstr.c_str());
+	Super::Init();
+
+	FRealmHostResolver::Prefetch(LOBBY_HOST);
+	FRealmHostResolver::Prefetch(GAME_SERVER_HOST);
+
+	bRecycleServer = IsRunningDedicatedServer() && FParse::Param(FCommandLine::Get(), TEXT("recycle"));
 }
 
 bool URealmGameInstance::ConnectLoginSocket()
 {
-	//try to establish a connection to the login server
-	if (!loginSocketThread || !loginSocket || loginSocket->GetConnectionState() != SCS_Connected)
+	if (!loginSocketThread)
 	{
-		FSocket* ls = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream, TEXT("login"), false);
-		auto resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName("realmmythos.ddns.net");
-
-		while (!resolveInfo->IsComplete());
-
-		uint32 outip = 0;
-		if (resolveInfo->GetErrorCode() == 0)
-		{
-			const FInternetAddr* addr = &resolveInfo->GetResolvedAddress();
-			addr->GetIp(outip);
-		}
-		else
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to resolve the hostname"));
+		loginSocketThread = FRealmSocketListener::CreateListener(GetLobbyHost(), LOGIN_PORT, true);
+		if (!loginSocketThread)
 			return false;
-		}
 
-		int32 port = 3308;
-		TSharedRef<FInternetAddr> addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
-		addr->SetIp(outip);
-		addr->SetPort(port);
-
-		int32 ReceiveBufferSize = 2 * 1024 * 1024;
-		int32 newSize = 0;
-		ls->SetReceiveBufferSize(ReceiveBufferSize, newSize);
-		ls->SetSendBufferSize(ReceiveBufferSize, newSize);
-
-		bool connected = ls->Connect(*addr);
-		if (!connected)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to connect to the login server"));
-			return false;
-		}
-
-		if (loginSocketThread)
-			loginSocketThread->EnsureCompletion();
-
-		loginSocketThread = FRealmSocketListener::CreateListener(ls, true);
 		loginSocketThread->gameInstance = this;
-		loginSocket = ls;
+	}
+
+	//the world changes between the menu and games, so make sure this world is polling
+	if (GetWorld() && !GetWorld()->GetTimerManager().IsTimerActive(loginSocketListenTimer))
+		GetWorld()->GetTimerManager().SetTimer(loginSocketListenTimer, this, &URealmGameInstance::ListenLoginSocket, 0.03f, true);
 
-		if (GetWorld())
-			GetWorld()->GetTimerManager().SetTimer(loginSocketListenTimer, this, &URealmGameInstance::ListenLoginSocket, 0.03f, true);
+	return true;
+}
 
-		UE_LOG(LogTemp, Warning, TEXT("connected to the login server"));
+bool URealmGameInstance::ConnectMultiplayerSocket()
+{
+	if (!multiplayerSocketThread)
+	{
+		multiplayerSocketThread = FRealmSocketListener::CreateListener(GetLobbyHost(), MULTIPLAYER_PORT, false);
+		if (!multiplayerSocketThread)
+			return false;
 
-		return true;
+		multiplayerSocketThread->gameInstance = this;
 	}
 
+	if (GetWorld() && !GetWorld()->GetTimerManager().IsTimerActive(multiplayerSocketListenTimer))
+		GetWorld()->GetTimerManager().SetTimer(multiplayerSocketListenTimer, this, &URealmGameInstance::ListenMultiplayerSocket, 0.03f, true);
+
 	return true;
 }
 
-bool URealmGameInstance::ConnectMultiplayerSocket()
+void URealmGameInstance::ListenLoginSocket()
 {
-	//try to establish a connection to the multiplayer master server
-	if (!multiplayerSocketThread || !multiplayerSocket || multiplayerSocket->GetConnectionState() != SCS_Connected)
-	{
-		FSocket* ms = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream, TEXT("multiplayer"), false);
-		auto resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName("realmmythos.ddns.net");
+	FLobbyMessage message;
 
-		while (!resolveInfo->IsComplete());
+	while (loginSocketThread && loginSocketThread->GetNextMessage(message))
+		DispatchLobbyMessage(message);
 
-		uint32 outip = 0;
-		if (resolveInfo->GetErrorCode() == 0)
-		{
-			const FInternetAddr* addr = &resolveInfo->GetResolvedAddress();
-			addr->GetIp(outip);
-		}
-		else
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to resolve the hostname"));
-			return false;
-		}
+	ExpireLobbyRequests(loginSocketThread, bLoginSocketWasConnected);
+}
 
-		int32 port = 3310;
+void URealmGameInstance::ListenMultiplayerSocket()
+{
+	FLobbyMessage message;
 
-		TSharedRef<FInternetAddr> addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
-		addr->SetIp(outip);
-		addr->SetPort(port);
+	while (multiplayerSocketThread && multiplayerSocketThread->GetNextMessage(message))
+		DispatchLobbyMessage(message);
 
-		int32 ReceiveBufferSize = 2 * 1024 * 1024;
-		int32 newSize = 0;
-		ms->SetReceiveBufferSize(ReceiveBufferSize, newSize);
-		ms->SetSendBufferSize(ReceiveBufferSize, newSize);
+	ExpireLobbyRequests(multiplayerSocketThread, bMultiplayerSocketWasConnected);
+}
 
-		bool connected = ms->Connect(*addr);
-		if (!connected)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("failed to connect to the multiplayer server"));
-			return false;
-		}
+uint32 URealmGameInstance::SendLobbyRequest(FRealmSocketListener* connection, FLobbyMessage& request)
+{
+	if (!connection)
+		return 0;
 
-		if (multiplayerSocketThread)
-			multiplayerSocketThread->EnsureCompletion();
+	//0 is reserved for messages the server sends on its own
+	if (nextCorrelationId == 0)
+		nextCorrelationId = 1;
 
-		multiplayerSocketThread = FRealmSocketListener::CreateListener(ms, false);
-		multiplayerSocketThread->gameInstance = this;
-		multiplayerSocket = ms;
+	request.correlationId = nextCorrelationId++;
 
-		if (GetWorld())
-			GetWorld()->GetTimerManager().SetTimer(multiplayerSocketListenTimer, this, &URealmGameInstance::ListenMultiplayerSocket, 0.03f, true);
+	FPendingLobbyRequest& pending = pendingLobbyRequests.Add(request.correlationId);
+	pending.messageId = request.messageId;
+	pending.sendTime = FPlatformTime::Seconds();
+	pending.connection = connection;
 
-		UE_LOG(LogTemp, Warning, TEXT("connected to the multiplayer server"));
-		return true;
-	}
+	//queued and sent once the connection is up
+	connection->Send(request);
+	return request.correlationId;
+}
+
+bool URealmGameInstance::SendLobbyNotification(FRealmSocketListener* connection, FLobbyMessage& notification)
+{
+	if (!connection)
+		return false;
 
+	notification.correlationId = 0;
+	connection->Send(notification);
 	return true;
 }
 
-void URealmGameInstance::ListenLoginSocket()
+void URealmGameInstance::ExpireLobbyRequests(FRealmSocketListener* connection, bool& bWasConnected)
 {
-	TArray<uint8> data;
+	if (!connection)
+		return;
 
-	if (loginSocketThread)
+	//anything in flight when the connection dropped won't be answered on the new one
+	const bool bConnected = connection->IsConnected();
+	const bool bDropped = bWasConnected && !bConnected;
+	bWasConnected = bConnected;
+
+	const double currentTime = FPlatformTime::Seconds();
+	for (auto itr = pendingLobbyRequests.CreateIterator(); itr; ++itr)
 	{
-		loginSocketThread->GetNextDataArray(data);
-		if (data.Num() > 0)
-			ParseLoginSocketData(data);
+		const FPendingLobbyRequest& pending = itr.Value();
+		if (pending.connection != connection)
+			continue;
+
+		if (bDropped || currentTime - pending.sendTime > LOBBY_REQUEST_TIMEOUT)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("lobby request %u (message %d) got no answer%s"), itr.Key(), (int32)pending.messageId, bDropped ? TEXT(" before the connection dropped") : TEXT(""));
+			itr.RemoveCurrent();
+		}
 	}
 }
 
-void URealmGameInstance::ListenMultiplayerSocket()
+void URealmGameInstance::DispatchLobbyMessage(const FLobbyMessage& message)
 {
-	TArray<uint8> data;
+	if (message.correlationId != 0 && pendingLobbyRequests.Remove(message.correlationId) == 0)
+		UE_LOG(LogTemp, Warning, TEXT("received a response for unknown request %u"), message.correlationId);
+
+	FLobbyHandler handler = lobbyHandlers[(uint8)message.messageId];
+	if (handler)
+		(this->*handler)(message);
+	else
+		UE_LOG(LogTemp, Warning, TEXT("received unhandled lobby message %d"), (int32)message.messageId);
+}
 
-	if (multiplayerSocketThread)
-	{
-		multiplayerSocketThread->GetNextDataArray(data);
-		if (data.Num() > 0)
-			ParseMultiplayerSocketData(data);
-	}
+ARealmMainMenu* URealmGameInstance::GetMainMenu() const
+{
+	return GetWorld() ? Cast<ARealmMainMenu>(GetWorld()->GetAuthGameMode()) : nullptr;
 }
 
-void URealmGameInstance::ParseLoginSocketData(const TArray<uint8>& ReceivedData)
+void URealmGameInstance::OnLoginSuccess(const FLobbyMessage& message)
 {
-	if (ReceivedData.Num() <= 0)
-	{
-		//No Data Received
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
 		return;
-	}
 
-	//VShow("Total Data read!", ReceivedData.Num());
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Data Bytes Read ~> %d"), ReceivedData.Num()));
+	//userid, experience, mythos points, alias
+	currentUserid = message.GetString(0);
+	currentMythosPoints = message.GetInt(2);
+	currentAlias = message.GetString(3);
 
+	mm->PlayerLoginSuccessful(currentUserid, message.GetInt(1), currentMythosPoints, currentAlias);
+	UE_LOG(LogTemp, Warning, TEXT("Logged in successfully as %s!"), *currentAlias);
+}
 
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-	const FString ReceivedUE4String = StringFromBinaryArray(ReceivedData);
-	//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void URealmGameInstance::OnLoginFailure(const FLobbyMessage& message)
+{
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
+		return;
 
-	ARealmMainMenu* mm = Cast<ARealmMainMenu>(GetWorld()->GetAuthGameMode());
+	mm->PlayerLoginNotSuccessful();
+	UE_LOG(LogTemp, Warning, TEXT("Failed to login!"));
+}
+
+void URealmGameInstance::OnCreateLoginSuccess(const FLobbyMessage& message)
+{
+	ARealmMainMenu* mm = GetMainMenu();
 	if (!IsValid(mm))
 		return;
 
-	TArray<FString> data;
-	ReceivedUE4String.ParseIntoArray(data, TEXT("|"), false);
+	mm->CreatePlayerLoginSuccessful();
+	UE_LOG(LogTemp, Warning, TEXT("Created new account successfully!"));
+}
 
-	if (data.Num() > 0)
-	{
-		//login parsing
-		if (data[0].Equals("loginSuccess"))
-		{
-			currentUserid = data[2];
-			currentAlias = data[8];
-			currentMythosPoints = FCString::Atoi(*data[6]);
+void URealmGameInstance::OnCreateLoginFailure(const FLobbyMessage& message)
+{
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
+		return;
 
-			mm->PlayerLoginSuccessful(currentUserid, FCString::Atoi(*data[4]), currentMythosPoints, currentAlias);
-			UE_LOG(LogTemp, Warning, TEXT("Logged in successfully as %s!"), *data[8]);
-		}
-		if (data[0].Equals("loginFailure"))
-		{
-			mm->PlayerLoginNotSuccessful();
-			UE_LOG(LogTemp, Warning, TEXT("Failed to login!"));
-		}
-		if (data[0].Equals("createLoginSuccess"))
-		{
-			mm->CreatePlayerLoginSuccessful();
-			UE_LOG(LogTemp, Warning, TEXT("Created new account successfully!"));
-		}
-		if (data[0].Equals("createLoginFailure"))
-		{
-			mm->CreatePlayerLoginUnsuccessful(data[1]);
-			UE_LOG(LogTemp, Warning, TEXT("Couldn't create new account. Reason: %s"), *data[1]);
-		}
-		if (data[0].Equals("updateInfo"))
-		{
-			ReceiveInfoUpdate(data[1], FCString::Atoi(*data[2]));
-			UE_LOG(LogTemp, Warning, TEXT("Received info update"));
-		}
+	const FString reason = message.GetString(0);
+	mm->CreatePlayerLoginUnsuccessful(reason);
+	UE_LOG(LogTemp, Warning, TEXT("Couldn't create new account. Reason: %s"), *reason);
+}
 
-		//multiplayer lobby parsing
+void URealmGameInstance::OnUpdateInfo(const FLobbyMessage& message)
+{
+	//alias, mythos points
+	ReceiveInfoUpdate(message.GetString(0), message.GetInt(1));
+}
 
-		//connectionSocket->Close();
-	}
+void URealmGameInstance::OnJoinedQueueSuccessfully(const FLobbyMessage& message)
+{
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
+		return;
 
-	//VShow("As String!!!!! ~>", ReceivedUE4String);
-	//GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("As String Data ~> %s"), *ReceivedUE4String));
+	mm->JoinMMQueueSuccessful();
+	UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue successfully "));
 }
 
-void URealmGameInstance::ParseMultiplayerSocketData(const TArray<uint8>& ReceivedData)
+void URealmGameInstance::OnJoinedQueueFailed(const FLobbyMessage& message)
 {
-	if (ReceivedData.Num() <= 0)
-	{
-		//No Data Received
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
 		return;
-	}
 
-	ARealmMainMenu* mm = Cast<ARealmMainMenu>(GetWorld()->GetAuthGameMode());
+	mm->JoinMMQueueFailed();
+	UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue failed "));
+}
+
+void URealmGameInstance::OnFoundMatch(const FLobbyMessage& message)
+{
+	ARealmMainMenu* mm = GetMainMenu();
 	if (!IsValid(mm))
 		return;
 
-	const FString ReceivedUE4String = StringFromBinaryArray(ReceivedData);
-	TArray<FString> data;
-	ReceivedUE4String.ParseIntoArray(data, TEXT("|"), false);
+	mm->FoundMatch(message.GetString(0));
+	UE_LOG(LogTemp, Warning, TEXT("MM found a match "));
+}
 
-	if (data.Num() > 0)
-	{
-		if (data[0].Equals("joinedQueueSuccessfully"))
-		{
-			mm->JoinMMQueueSuccessful();
-			UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue successfully "));
-		}
-		if (data[0].Equals("joinedQueueFailed"))
-		{
-			mm->JoinMMQueueFailed();
-			UE_LOG(LogTemp, Warning, TEXT("Joined the MM queue failed "));
-		}
-		if (data[0].Equals("foundMatch"))
-		{
-			mm->FoundMatch(data[1]);
-			UE_LOG(LogTemp, Warning, TEXT("MM found a match "));
-		}
-		if (data[0].Equals("foundMatchConfirmed"))
-		{
-			mm->FoundConfirmedMatch(data[1]);
-			UE_LOG(LogTemp, Warning, TEXT("MM found a confirmed match"));
-		}
-		if (data[0].Equals("matchConfirmFailed"))
-		{
-			mm->FailedToConfirmMatch();
-			UE_LOG(LogTemp, Warning, TEXT("MM failed to confirm a match "));
-		}
-	}
+void URealmGameInstance::OnFoundMatchConfirmed(const FLobbyMessage& message)
+{
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
+		return;
+
+	mm->FoundConfirmedMatch(message.GetString(0));
+	UE_LOG(LogTemp, Warning, TEXT("MM found a confirmed match"));
 }
 
-bool URealmGameInstance::AttemptLogin(FString username, FString password)
+void URealmGameInstance::OnMatchConfirmFailed(const FLobbyMessage& message)
 {
-	if (!ConnectLoginSocket())
-		return false;
+	ARealmMainMenu* mm = GetMainMenu();
+	if (!IsValid(mm))
+		return;
 
-	//encode username
-	FString serialized = "login|username|";
-	serialized = serialized + username;
+	mm->FailedToConfirmMatch();
+	UE_LOG(LogTemp, Warning, TEXT("MM failed to confirm a match "));
+}
 
-	//encode encrypted password
-	FString serialized1 = "|password|";
+FString URealmGameInstance::HashPassword(const FString& password)
+{
+	FTCHARToUTF8 utf8(*password);
 
-	std::string stdstring(TCHAR_TO_UTF8(*password));
 	FSHA1 hashState;
-	hashState.Update((uint8*)stdstring.c_str(), stdstring.size());
+	hashState.Update((const uint8*)utf8.Get(), utf8.Length());
 	hashState.Final();
 
 	uint8 passwordHash[FSHA1::DigestSize];
 	hashState.GetHash(passwordHash);
-	FString pwdStr = BytesToHex(passwordHash, FSHA1::DigestSize);
-	serialized1 = serialized1 + pwdStr;
-
-	//get the full login string
-	FString prStr = serialized + serialized1;
-
-	//send the encrypted data to the login server
-	TCHAR *serializedChar = prStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = loginSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return false;
-	}
-
-	return true;
+	return BytesToHex(passwordHash, FSHA1::DigestSize);
 }
 
-bool URealmGameInstance::AttemptCreateLogin(FString& username, FString& password, FString& email, FString& ingameAlias, FString& alphaCode)
+bool URealmGameInstance::AttemptLogin(FString username, FString password)
 {
 	if (!ConnectLoginSocket())
 		return false;
 
-	FString sendStr = "loginCreate|username|";
-	sendStr += username;
-	sendStr += "|password|";
+	FLobbyMessage request(ELobbyMessage::Login);
+	request.AddString(username).AddString(HashPassword(password));
 
-	std::string stdstring(TCHAR_TO_UTF8(*password));
-	FSHA1 hashState;
-	hashState.Update((uint8*)stdstring.c_str(), stdstring.size());
-	hashState.Final();
+	return SendLobbyRequest(loginSocketThread, request) != 0;
+}
 
-	uint8 passwordHash[FSHA1::DigestSize];
-	hashState.GetHash(passwordHash);
-	FString pwdStr = BytesToHex(passwordHash, FSHA1::DigestSize);
-
-	sendStr += pwdStr;
-	sendStr += "|email|" + email;
-	sendStr += "|ingame|" + ingameAlias;
-	sendStr += "|alphaCode|" + alphaCode;
-
-	//send the encrypted data to the login server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
-
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = loginSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
+bool URealmGameInstance::AttemptCreateLogin(FString& username, FString& password, FString& email, FString& ingameAlias, FString& alphaCode)
+{
+	if (!ConnectLoginSocket())
 		return false;
-	}
 
-	return true;
+	FLobbyMessage request(ELobbyMessage::LoginCreate);
+	request.AddString(username).AddString(HashPassword(password)).AddString(email).AddString(ingameAlias).AddString(alphaCode);
+
+	return SendLobbyRequest(loginSocketThread, request) != 0;
 }
 
 void URealmGameInstance::SendMatchComplete(ARealmGameMode* gameMode)
@@ -368,28 +352,23 @@ void URealmGameInstance::SendMatchComplete(ARealmGameMode* gameMode)
 		if (!ConnectMultiplayerSocket())
 			return;
 
-		FString sendStr = "rankedGameFinished|";
-		for (int32 i = 0; i < gameMode->endgameUserids.Num(); i++)
-			sendStr += gameMode->endgameUserids[i] + ",";
-		sendStr += "|";
-		for (int32 j = 0; j < gameMode->endgameTeams.Num(); j++)
-			sendStr += FString::FromInt(gameMode->endgameTeams[j]) + ",";
-		sendStr += "|" + FString::FromInt(gameMode->winningTeamIndex);
-
-		//send the data to the server
-		TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-		int32 encSize = FCString::Strlen(serializedChar);
-		int32 sent = 0;
-
-		//send and store whether or not it was successful
-		bool bSuccesfullySent = multiplayerSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-		if (bSuccesfullySent)
-			UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-		if (!bSuccesfullySent)
-			UE_LOG(LogTemp, Warning, TEXT("failed to send"));
+		//winning team, player count, then a userid and team for each player
+		const int32 playerCount = FMath::Min(gameMode->endgameUserids.Num(), gameMode->endgameTeams.Num());
 
+		FLobbyMessage request(ELobbyMessage::RankedGameFinished);
+		request.AddInt(gameMode->winningTeamIndex).AddInt(playerCount);
+		for (int32 i = 0; i < playerCount; i++)
+			request.AddString(gameMode->endgameUserids[i]).AddInt(gameMode->endgameTeams[i]);
+
+		//the server records the result without answering
+		SendLobbyNotification(multiplayerSocketThread, request);
+
+		//give the players the same time on the endgame screen either way
 		FTimerHandle exitTimer;
-		gameMode->GetWorldTimerManager().SetTimer(exitTimer, this, &URealmGameInstance::CloseGameInstance, 35.f, false);
+		if (bRecycleServer)
+			gameMode->GetWorldTimerManager().SetTimer(exitTimer, this, &URealmGameInstance::RecycleServer, 35.f, false);
+		else
+			gameMode->GetWorldTimerManager().SetTimer(exitTimer, this, &URealmGameInstance::CloseGameInstance, 35.f, false);
 	}
 }
 
@@ -398,74 +377,136 @@ void URealmGameInstance::CloseGameInstance()
 	FGenericPlatformMisc::RequestExit(false);
 }
 
-FString URealmGameInstance::GetRealmServerIP(int32 port)
+void URealmGameInstance::KeepAssetsWarm(ARealmGameMode* gameMode)
 {
-	auto resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName("mythosrealm.ddns.net");
+	if (!IsValid(gameMode))
+		return;
 
-	while (!resolveInfo->IsComplete());
+	for (TSubclassOf<APlayerCharacter> characterClass : gameMode->availableCharacters)
+	{
+		if (*characterClass)
+			warmAssets.AddUnique(*characterClass);
+	}
 
-	uint32 outip = 0;
-	if (resolveInfo->GetErrorCode() == 0)
+	for (TSubclassOf<AMod> modClass : gameMode->storeMods)
 	{
-		const FInternetAddr* addr = &resolveInfo->GetResolvedAddress();
-		addr->GetIp(outip);
+		if (*modClass)
+			warmAssets.AddUnique(*modClass);
 	}
 
-	FIPv4Address ip = FIPv4Address(outip);
-	FString ipstr = ip.ToText().ToString();
-	ipstr += ":" + port;
+	for (TSubclassOf<ARaiderCharacter> raiderClass : gameMode->raiderTypes)
+	{
+		if (*raiderClass)
+			warmAssets.AddUnique(*raiderClass);
+	}
+}
+
+void URealmGameInstance::RecycleServer()
+{
+	UWorld* world = GetWorld();
+	if (!world)
+	{
+		CloseGameInstance();
+		return;
+	}
+
+	//everyone has their results by now, send them back to the menu so the map can reload empty
+	for (FConstPlayerControllerIterator plyr = world->GetPlayerControllerIterator(); plyr; ++plyr)
+	{
+		APlayerController* pc = *plyr;
+		if (IsValid(pc))
+			pc->ClientReturnToMainMenu(TEXT("The match has ended."));
+	}
+
+	recycleStartTime = FPlatformTime::Seconds();
+
+	//reloading the map resets the game mode and state to pregame and respawns lanes, camps and objectives. the map
+	//load itself is still paid in full, what's skipped is the process start and engine init, and the gameplay classes
+	//held in warmAssets don't have to load again. the options the server was started with carry over to the new map
+	FString travelURL = world->URL.Map;
+	for (const FString& option : world->URL.Op)
+		travelURL += TEXT("?") + option;
 
-	return ipstr;
+	if (!world->ServerTravel(travelURL, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("couldn't recycle the server, exiting instead"));
+		CloseGameInstance();
+	}
 }
 
-bool URealmGameInstance::AttemptJoinSoloMMQueue(const FString& queue)
+void URealmGameInstance::ServerReadyForMatch(ARealmGameMode* gameMode)
 {
-	if (!ConnectMultiplayerSocket())
-		return false;
+	if (!IsRunningDedicatedServer() || !IsValid(gameMode))
+		return;
 
-	FString sendStr = "playerWantsMMQueue|" + GetUserID() + "|" + queue;
+	KeepAssetsWarm(gameMode);
 
-	//send the data to the server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
+	float readyTime = 0.f;
+	const bool bColdStart = recycleStartTime <= 0.0;
+	if (bColdStart)
+	{
+		readyTime = (float)(FPlatformTime::Seconds() - GStartTime);
+		coldStartReadyTime = readyTime;
 
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = multiplayerSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
+		UE_LOG(LogTemp, Warning, TEXT("server ready after a cold start in %.2f seconds"), readyTime);
+	}
+	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return false;
+		readyTime = (float)(FPlatformTime::Seconds() - recycleStartTime);
+		recycleStartTime = 0.0;
+
+		warmRecycleCount++;
+		averageWarmReadyTime += (readyTime - averageWarmReadyTime) / warmRecycleCount;
+
+		UE_LOG(LogTemp, Warning, TEXT("server recycled and ready in %.2f seconds (average %.2f over %d recycles, cold start took %.2f)"),
+			readyTime, averageWarmReadyTime, warmRecycleCount, coldStartReadyTime);
+
+		//recycled servers have to tell the matchmaker they're free again, cold ones were started by it
+		if (ConnectMultiplayerSocket())
+		{
+			FLobbyMessage request(ELobbyMessage::ServerReady);
+			request.AddInt(GetWorld()->URL.Port).AddInt(FMath::RoundToInt(readyTime * 1000.f)).AddInt(FMath::RoundToInt(coldStartReadyTime * 1000.f));
+
+			//the matchmaker doesn't answer this
+			SendLobbyNotification(multiplayerSocketThread, request);
+		}
 	}
+}
 
-	return true;
+FString URealmGameInstance::GetRealmServerIP(int32 port)
+{
+	//never wait on dns here. if the address isn't cached yet, travel will resolve the host name itself
+	uint32 outip = 0;
+	if (!FRealmHostResolver::GetCachedAddress(GAME_SERVER_HOST, outip))
+	{
+		FRealmHostResolver::Prefetch(GAME_SERVER_HOST);
+		return FString::Printf(TEXT("%s:%d"), *GAME_SERVER_HOST, port);
+	}
+
+	FIPv4Address ip = FIPv4Address(outip);
+	return FString::Printf(TEXT("%s:%d"), *ip.ToText().ToString(), port);
 }
 
-bool URealmGameInstance::SendConfirmMatch(const FString& matchID)
+bool URealmGameInstance::AttemptJoinSoloMMQueue(const FString& queue)
 {
 	if (!ConnectMultiplayerSocket())
 		return false;
 
-	FString sendStr = "playerConfirmMatch|" + GetUserID() + "|" + matchID;
+	FLobbyMessage request(ELobbyMessage::JoinQueue);
+	request.AddString(GetUserID()).AddString(queue);
 
-	//send the data to the server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
+	return SendLobbyRequest(multiplayerSocketThread, request) != 0;
+}
 
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = multiplayerSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
+bool URealmGameInstance::SendConfirmMatch(const FString& matchID)
+{
+	if (!ConnectMultiplayerSocket())
 		return false;
-	}
 
-	return true;
+	FLobbyMessage request(ELobbyMessage::ConfirmMatch);
+	request.AddString(GetUserID()).AddString(matchID);
+
+	return SendLobbyRequest(multiplayerSocketThread, request) != 0;
 }
 
 void URealmGameInstance::QueryLoginServerForUpdate()
@@ -473,22 +514,10 @@ void URealmGameInstance::QueryLoginServerForUpdate()
 	if (!ConnectLoginSocket())
 		return;
 
-	FString sendStr = "getInfoUpdate|" + GetUserID();
-
-	//send the data to the server
-	TCHAR *serializedChar = sendStr.GetCharArray().GetData();
-	int32 encSize = FCString::Strlen(serializedChar);
-	int32 sent = 0;
+	FLobbyMessage request(ELobbyMessage::GetInfoUpdate);
+	request.AddString(GetUserID());
 
-	//send and store whether or not it was successful
-	bool bSuccesfullySent = loginSocket->Send((uint8*)TCHAR_TO_UTF8(serializedChar), encSize, sent);
-	if (bSuccesfullySent)
-		UE_LOG(LogTemp, Warning, TEXT("sent %d bytes to the server"), sent);
-	if (!bSuccesfullySent)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("failed to send"));
-		return;
-	}
+	SendLobbyRequest(loginSocketThread, request);
 }
 
 void URealmGameInstance::ReceiveInfoUpdate(const FString& alias, int32 mp)
@@ -497,4 +526,4 @@ void URealmGameInstance::ReceiveInfoUpdate(const FString& alias, int32 mp)
 	currentMythosPoints = mp;
 
 	UE_LOG(LogTemp, Warning, TEXT("received info update"));
-}
\ No newline at end of file
+}
@@ -1,12 +1,30 @@
 #include "Realm.h"
 #include "RealmGameState.h"
-#include "Chat.h"
 #include "RealmPlayerState.h"
+#include "RealmPlayerController.h"
 
 ARealmGameState::ARealmGameState(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
 	matchStartTime = -1.f;
+	gameChatHead = 0;
+}
+
+void ARealmGameState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!groundHeightfield)
+		groundHeightfield = MakeUnique<FRealmGroundHeightfield>();
+
+	groundHeightfield->Bake(GetWorld());
+}
+
+void ARealmGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	groundHeightfield.Reset();
 }
 
 void ARealmGameState::BroadcastObjectiveDeath_Implementation(APawn* killerPawn, ARealmObjective* objectiveDestroyed)
@@ -38,30 +56,65 @@ int32 ARealmGameState::GetTeamScore(int32 index) const
 		return -1;
 }
 
-void ARealmGameState::BroadcastChat_Implementation(const FRealmChatEntry& broadcastChat)
+void ARealmGameState::BroadcastChat(const FRealmChatEntry& broadcastChat)
 {
-	gameChat.Add(broadcastChat);
-	
-	if (Role < ROLE_Authority || (Role == ROLE_Authority && GetNetMode() == NM_ListenServer))
+	if (Role < ROLE_Authority)
+		return;
+
+	AddChatToHistory(broadcastChat);
+
+	//only the connections that are allowed to see the chat get sent it
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
 	{
-		for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+		ARealmPlayerController* TestPC = Cast<ARealmPlayerController>(*It);
+		if (!IsValid(TestPC))
+			continue;
+
+		if (!broadcastChat.bAllChat)
 		{
-			ARealmPlayerController* TestPC = Cast<ARealmPlayerController>(*It);
 			ARealmPlayerState* ps = Cast<ARealmPlayerState>(TestPC->PlayerState);
-			if (broadcastChat.bAllChat)
-			{
-				if (IsValid(TestPC) && TestPC->IsLocalController())
-					TestPC->ClientReceiveChat(broadcastChat);
-			}
-			else if (IsValid(ps))
-			{
-				if (IsValid(TestPC) && TestPC->IsLocalController() && ps->GetTeamIndex() == broadcastChat.senderTeamIndex)
-					TestPC->ClientReceiveChat(broadcastChat);
-			}
+			if (!IsValid(ps) || ps->GetTeamIndex() != broadcastChat.senderTeamIndex)
+				continue;
 		}
+
+		TestPC->ClientReceiveChat(broadcastChat);
 	}
 }
 
+void ARealmGameState::AddChatToHistory(const FRealmChatEntry& chatEntry)
+{
+	if (gameChat.Num() < CHAT_HISTORY_SIZE)
+		gameChat.Add(chatEntry);
+	else
+		gameChat[gameChatHead] = chatEntry;
+
+	gameChatHead = (gameChatHead + 1) % CHAT_HISTORY_SIZE;
+}
+
+void ARealmGameState::GetChatHistory(TArray<FRealmChatEntry>& outHistory) const
+{
+	outHistory.Reset(gameChat.Num());
+
+	//until the buffer wraps the oldest entry is the first one
+	const int32 oldest = gameChat.Num() < CHAT_HISTORY_SIZE ? 0 : gameChatHead;
+	for (int32 i = 0; i < gameChat.Num(); i++)
+		outHistory.Add(gameChat[(oldest + i) % gameChat.Num()]);
+}
+
+ARealmPlayerState* ARealmGameState::FindPlayerStateById(int32 playerId) const
+{
+	if (playerId < 0)
+		return nullptr;
+
+	for (APlayerState* ps : PlayerArray)
+	{
+		if (IsValid(ps) && ps->PlayerId == playerId)
+			return Cast<ARealmPlayerState>(ps);
+	}
+
+	return nullptr;
+}
+
 void ARealmGameState::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
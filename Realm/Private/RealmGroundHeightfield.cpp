@@ -0,0 +1,139 @@
+#include "Realm.h"
+#include "RealmGroundHeightfield.h"
+#include "RealmGameState.h"
+
+const float FRealmGroundHeightfield::DefaultCellSize = 50.f;
+const float FRealmGroundHeightfield::MaxInterpolatedStep = 60.f;
+
+FRealmGroundHeightfield::FRealmGroundHeightfield()
+{
+	origin = FVector2D::ZeroVector;
+	cellSize = DefaultCellSize;
+	sizeX = 0;
+	sizeY = 0;
+	traceTop = 0.f;
+}
+
+bool FRealmGroundHeightfield::TraceGround(UWorld* world, const FVector& start, float traceDistance, FVector& outLocation)
+{
+	FVector end = start;
+	end.Z -= traceDistance;
+
+	//only static geometry is ground, so characters and projectiles never have to be gathered up and ignored
+	FHitResult hit;
+	if (world->LineTraceSingleByObjectType(hit, start, end, FCollisionObjectQueryParams(ECC_WorldStatic)))
+	{
+		outLocation = hit.ImpactPoint;
+		return true;
+	}
+
+	return false;
+}
+
+void FRealmGroundHeightfield::Bake(UWorld* world)
+{
+	heights.Reset();
+	validSamples.Empty();
+
+	if (!world)
+		return;
+
+	const double bakeStart = FPlatformTime::Seconds();
+
+	//the area covered by colliding static actors is the area anything can stand on
+	FBox levelBounds(0);
+	for (TActorIterator<AActor> itr(world); itr; ++itr)
+	{
+		AActor* actor = *itr;
+		if (IsValid(actor) && actor->IsRootComponentStatic() && actor->GetActorEnableCollision())
+			levelBounds += actor->GetComponentsBoundingBox(false);
+	}
+
+	if (!levelBounds.IsValid)
+		return;
+
+	cellSize = DefaultCellSize;
+	while (levelBounds.GetSize().X / cellSize >= MaxSamplesPerAxis || levelBounds.GetSize().Y / cellSize >= MaxSamplesPerAxis)
+		cellSize *= 2.f;
+
+	origin = FVector2D(levelBounds.Min.X, levelBounds.Min.Y);
+	sizeX = FMath::CeilToInt(levelBounds.GetSize().X / cellSize) + 1;
+	sizeY = FMath::CeilToInt(levelBounds.GetSize().Y / cellSize) + 1;
+	traceTop = levelBounds.Max.Z + 1.f;
+
+	const float traceDistance = levelBounds.GetSize().Z + 2.f;
+
+	heights.SetNumZeroed(sizeX * sizeY);
+	validSamples.Init(false, sizeX * sizeY);
+
+	int32 validCount = 0;
+	for (int32 y = 0; y < sizeY; y++)
+	{
+		for (int32 x = 0; x < sizeX; x++)
+		{
+			FVector ground;
+			if (TraceGround(world, FVector(origin.X + x * cellSize, origin.Y + y * cellSize, traceTop), traceDistance, ground))
+			{
+				heights[y * sizeX + x] = ground.Z;
+				validSamples[y * sizeX + x] = true;
+				validCount++;
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("baked a %dx%d ground heightfield at %.0f units per sample (%d with ground) in %.2f seconds"),
+		sizeX, sizeY, cellSize, validCount, FPlatformTime::Seconds() - bakeStart);
+}
+
+bool FRealmGroundHeightfield::GetGroundHeight(const FVector& point, float& outHeight) const
+{
+	if (!IsBaked())
+		return false;
+
+	const float fx = (point.X - origin.X) / cellSize;
+	const float fy = (point.Y - origin.Y) / cellSize;
+	const int32 x = FMath::FloorToInt(fx);
+	const int32 y = FMath::FloorToInt(fy);
+
+	if (x < 0 || y < 0 || x >= sizeX - 1 || y >= sizeY - 1)
+		return false;
+
+	const int32 index = y * sizeX + x;
+	if (!validSamples[index] || !validSamples[index + 1] || !validSamples[index + sizeX] || !validSamples[index + sizeX + 1])
+		return false;
+
+	const float h00 = heights[index];
+	const float h10 = heights[index + 1];
+	const float h01 = heights[index + sizeX];
+	const float h11 = heights[index + sizeX + 1];
+
+	//walls and ledges between samples would be smoothed into ramps
+	const float lowest = FMath::Min(FMath::Min(h00, h10), FMath::Min(h01, h11));
+	const float highest = FMath::Max(FMath::Max(h00, h10), FMath::Max(h01, h11));
+	if (highest - lowest > MaxInterpolatedStep)
+		return false;
+
+	const float tx = fx - x;
+	const float ty = fy - y;
+	outHeight = FMath::Lerp(FMath::Lerp(h00, h10, tx), FMath::Lerp(h01, h11, tx), ty);
+	return true;
+}
+
+FVector FRealmGroundHeightfield::FindGroundBeneathPoint(UWorld* world, const FVector& point, float traceDistance)
+{
+	if (!world)
+		return point;
+
+	//the baked ground is the top surface, a point beneath it is under an overhang and has to trace
+	ARealmGameState* gs = world->GetGameState<ARealmGameState>();
+	float groundHeight = 0.f;
+	if (IsValid(gs) && gs->groundHeightfield.IsValid() && gs->groundHeightfield->GetGroundHeight(point, groundHeight) &&
+		groundHeight <= point.Z && point.Z - groundHeight <= traceDistance)
+		return FVector(point.X, point.Y, groundHeight);
+
+	FVector ground;
+	if (TraceGround(world, point, traceDistance, ground))
+		return ground;
+
+	return point;
+}
@@ -0,0 +1,258 @@
+#include "Realm.h"
+#include "RealmLagCompensation.h"
+#include "RealmGameMode.h"
+#include "GameCharacter.h"
+#include "RealmPlayerController.h"
+
+static TAutoConsoleVariable<int32> CVarLagCompensation(TEXT("realm.LagCompensation"), 1, TEXT("1 checks skill shots and projectiles from players against where their targets were on the shooter's screen, 0 uses where the targets are now."));
+
+/* closest points between segments a0-a1 and b0-b1, as fractions along each. parallel segments are handled, which
+   matters since both capsules and the cone trace's sweeps run straight up */
+static void ClosestPointsOnSegments(const FVector& a0, const FVector& a1, const FVector& b0, const FVector& b1, float& outS, float& outT)
+{
+	const FVector da = a1 - a0;
+	const FVector db = b1 - b0;
+	const FVector r = a0 - b0;
+
+	const float lengthA = da.SizeSquared();
+	const float lengthB = db.SizeSquared();
+	const float f = FVector::DotProduct(db, r);
+
+	if (lengthA <= SMALL_NUMBER && lengthB <= SMALL_NUMBER)
+	{
+		outS = 0.f;
+		outT = 0.f;
+		return;
+	}
+
+	if (lengthA <= SMALL_NUMBER)
+	{
+		outS = 0.f;
+		outT = FMath::Clamp(f / lengthB, 0.f, 1.f);
+		return;
+	}
+
+	const float c = FVector::DotProduct(da, r);
+	if (lengthB <= SMALL_NUMBER)
+	{
+		outT = 0.f;
+		outS = FMath::Clamp(-c / lengthA, 0.f, 1.f);
+		return;
+	}
+
+	const float b = FVector::DotProduct(da, db);
+	const float denom = lengthA * lengthB - b * b;
+
+	//parallel segments have no single closest pair, any point on a works
+	outS = denom > SMALL_NUMBER ? FMath::Clamp((b * f - c * lengthB) / denom, 0.f, 1.f) : 0.f;
+	outT = (b * outS + f) / lengthB;
+
+	if (outT < 0.f)
+	{
+		outT = 0.f;
+		outS = FMath::Clamp(-c / lengthA, 0.f, 1.f);
+	}
+	else if (outT > 1.f)
+	{
+		outT = 1.f;
+		outS = FMath::Clamp((b - c) / lengthA, 0.f, 1.f);
+	}
+}
+
+URealmLagCompensation::URealmLagCompensation(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	gameOwner = nullptr;
+	frameCount = 0;
+
+	for (int32 i = 0; i < LAG_COMPENSATION_HISTORY_SIZE; i++)
+		frameTimes[i] = 0.f;
+}
+
+URealmLagCompensation* URealmLagCompensation::Get(UWorld* world)
+{
+	ARealmGameMode* gm = world ? Cast<ARealmGameMode>(world->GetAuthGameMode()) : nullptr;
+	return IsValid(gm) && IsValid(gm->lagCompensation) ? gm->lagCompensation : nullptr;
+}
+
+AGameCharacter* URealmLagCompensation::GetShooterCharacter(AActor* shooter)
+{
+	//skills and projectiles are owned by the character that used them
+	for (AActor* actor = shooter; IsValid(actor); actor = actor->GetOwner())
+	{
+		AGameCharacter* gc = Cast<AGameCharacter>(actor);
+		if (gc)
+			return gc;
+	}
+
+	return nullptr;
+}
+
+void URealmLagCompensation::RecordPositions()
+{
+	UWorld* gameWorld = IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr;
+	if (!gameWorld)
+		return;
+
+	const float currentTime = gameWorld->GetTimeSeconds();
+
+	//a fast server would otherwise shrink the window the history covers
+	if (frameCount > 0 && currentTime - frameTimes[(frameCount - 1) % LAG_COMPENSATION_HISTORY_SIZE] < LAG_COMPENSATION_MIN_INTERVAL)
+		return;
+
+	const int32 frame = frameCount++;
+	const int32 slot = frame % LAG_COMPENSATION_HISTORY_SIZE;
+	frameTimes[slot] = currentTime;
+
+	bool bStale = false;
+	for (TActorIterator<AGameCharacter> itr(gameWorld); itr; ++itr)
+	{
+		AGameCharacter* gc = *itr;
+		if (!IsValid(gc))
+			continue;
+
+		int32* historyIndex = historyIndices.Find(gc);
+		if (!historyIndex)
+		{
+			const int32 newIndex = histories.AddDefaulted();
+			historyIndex = &historyIndices.Add(gc, newIndex);
+
+			FRealmPositionHistory& newHistory = histories[newIndex];
+			newHistory.character = gc;
+			newHistory.firstFrame = frame;
+			newHistory.teleportFrame = INDEX_NONE;
+			gc->GetCapsuleComponent()->GetScaledCapsuleSize(newHistory.radius, newHistory.halfHeight);
+		}
+
+		FRealmPositionHistory& history = histories[*historyIndex];
+		history.locations[slot] = gc->GetActorLocation();
+		history.lastFrame = frame;
+	}
+
+	for (const FRealmPositionHistory& history : histories)
+	{
+		if (history.lastFrame != frame)
+		{
+			bStale = true;
+			break;
+		}
+	}
+
+	if (bStale)
+		RemoveStaleHistories();
+}
+
+void URealmLagCompensation::MarkTeleported(AGameCharacter* character)
+{
+	int32* historyIndex = historyIndices.Find(character);
+	if (historyIndex)
+		histories[*historyIndex].teleportFrame = frameCount;
+}
+
+void URealmLagCompensation::RemoveStaleHistories()
+{
+	const int32 currentFrame = frameCount - 1;
+
+	for (int32 i = histories.Num() - 1; i >= 0; i--)
+	{
+		if (histories[i].lastFrame != currentFrame || !histories[i].character.IsValid())
+			histories.RemoveAtSwap(i, 1, false);
+	}
+
+	historyIndices.Reset();
+	for (int32 i = 0; i < histories.Num(); i++)
+		historyIndices.Add(histories[i].character.Get(), i);
+}
+
+FVector URealmLagCompensation::GetRewoundLocation(const FRealmPositionHistory& history, float time) const
+{
+	const int32 oldestFrame = FMath::Max(GetOldestFrame(), history.firstFrame);
+	const int32 newestFrame = history.lastFrame;
+
+	//walk back to the first frame at or before the time and blend towards the one after it
+	for (int32 frame = newestFrame; frame > oldestFrame; frame--)
+	{
+		const int32 slot = frame % LAG_COMPENSATION_HISTORY_SIZE;
+		const int32 previousSlot = (frame - 1) % LAG_COMPENSATION_HISTORY_SIZE;
+
+		if (frameTimes[previousSlot] > time)
+			continue;
+
+		if (frame == newestFrame && frameTimes[slot] <= time)
+			return history.locations[slot];
+
+		//the character was in one place or the other, never on the line between them
+		if (frame == history.teleportFrame)
+			return frameTimes[slot] <= time ? history.locations[slot] : history.locations[previousSlot];
+
+		const float frameLength = frameTimes[slot] - frameTimes[previousSlot];
+		const float alpha = frameLength > 0.f ? FMath::Clamp((time - frameTimes[previousSlot]) / frameLength, 0.f, 1.f) : 1.f;
+		return FMath::Lerp(history.locations[previousSlot], history.locations[slot], alpha);
+	}
+
+	return history.locations[oldestFrame % LAG_COMPENSATION_HISTORY_SIZE];
+}
+
+float URealmLagCompensation::GetRewindTime(AActor* shooter) const
+{
+	if (CVarLagCompensation.GetValueOnGameThread() == 0)
+		return 0.f;
+
+	AGameCharacter* gc = GetShooterCharacter(shooter);
+	ARealmPlayerController* pc = IsValid(gc) ? gc->GetPlayerController() : nullptr;
+	if (!IsValid(pc) || !IsValid(pc->PlayerState))
+		return 0.f;
+
+	//the player acted half a round trip before the server heard about it, on positions that were already half a round trip old
+	return FMath::Clamp(pc->PlayerState->ExactPing * 0.001f, 0.f, LAG_COMPENSATION_MAX_REWIND);
+}
+
+bool URealmLagCompensation::SweepCharacters(AActor* ignoredActor, const FVector& start, const FVector& end, float radius, float rewindTime, TArray<FHitResult>& hitsOut) const
+{
+	UWorld* gameWorld = IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr;
+	if (!gameWorld || frameCount == 0)
+		return false;
+
+	const float rewoundTime = gameWorld->GetTimeSeconds() - FMath::Clamp(rewindTime, 0.f, LAG_COMPENSATION_MAX_REWIND);
+	const int32 firstHit = hitsOut.Num();
+
+	for (const FRealmPositionHistory& history : histories)
+	{
+		AGameCharacter* gc = history.character.Get();
+		if (!IsValid(gc) || gc == ignoredActor || !gc->IsAlive())
+			continue;
+
+		//capsule as the segment between the centers of its end spheres
+		const FVector location = GetRewoundLocation(history, rewoundTime);
+		const FVector axis(0.f, 0.f, FMath::Max(history.halfHeight - history.radius, 0.f));
+
+		float s, t;
+		ClosestPointsOnSegments(start, end, location - axis, location + axis, s, t);
+
+		const FVector sweepPoint = FMath::Lerp(start, end, s);
+		const FVector capsulePoint = FMath::Lerp(location - axis, location + axis, t);
+		if ((sweepPoint - capsulePoint).SizeSquared() > FMath::Square(radius + history.radius))
+			continue;
+
+		const FVector normal = (sweepPoint - capsulePoint).GetSafeNormal();
+
+		FHitResult hit(gc, gc->GetCapsuleComponent(), capsulePoint + normal * history.radius, normal);
+		hit.Time = s;
+		hit.Location = sweepPoint;
+		hit.TraceStart = start;
+		hit.TraceEnd = end;
+		hit.bStartPenetrating = s <= 0.f;
+		hitsOut.Add(hit);
+	}
+
+	//nearest first, like the physics sweeps
+	if (hitsOut.Num() > firstHit)
+	{
+		Sort(hitsOut.GetData() + firstHit, hitsOut.Num() - firstHit, [](const FHitResult& a, const FHitResult& b)
+		{
+			return a.Time < b.Time;
+		});
+	}
+
+	return hitsOut.Num() > firstHit;
+}
@@ -0,0 +1,456 @@
+#include "Realm.h"
+#include "RealmLaneAvoidance.h"
+#include "RealmGameMode.h"
+#include "GameCharacter.h"
+#include "LaneManager.h"
+#include "RealmCharacterMovementComponent.h"
+#if WITH_RECAST
+#include "DetourCrowd/DetourObstacleAvoidance.h"
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Lane Avoidance Gather"), STAT_RealmLaneAvoidanceGather, STATGROUP_RealmAvoidance);
+DECLARE_CYCLE_STAT(TEXT("Lane Avoidance Solve"), STAT_RealmLaneAvoidanceSolve, STATGROUP_RealmAvoidance);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lane Avoidance Agents"), STAT_RealmLaneAvoidanceAgents, STATGROUP_RealmAvoidance);
+
+static TAutoConsoleVariable<int32> CVarLaneAvoidance(TEXT("realm.LaneAvoidance"), 1, TEXT("1 steers new lane minions with the batched lane avoidance solver, 0 leaves them on the detour crowd simulation. Compare with stat RealmAvoidance and stat AICrowd."));
+
+/* neighbors of one agent relative to it, padded out to a multiple of four with entries that can never collide */
+struct FLaneAvoidanceNeighbors
+{
+	MS_ALIGN(16) float positionX[LANE_AVOIDANCE_MAX_NEIGHBORS] GCC_ALIGN(16);
+	MS_ALIGN(16) float positionY[LANE_AVOIDANCE_MAX_NEIGHBORS] GCC_ALIGN(16);
+	MS_ALIGN(16) float velocityX[LANE_AVOIDANCE_MAX_NEIGHBORS] GCC_ALIGN(16);
+	MS_ALIGN(16) float velocityY[LANE_AVOIDANCE_MAX_NEIGHBORS] GCC_ALIGN(16);
+	MS_ALIGN(16) float radius[LANE_AVOIDANCE_MAX_NEIGHBORS] GCC_ALIGN(16);
+
+	int32 count;
+
+	/* gather the agents that the one at index avoids, within the neighbor radius */
+	void Gather(const FLaneAvoidanceAgents& agents, int32 index, float neighborRadiusSq)
+	{
+		count = 0;
+
+		const float x = agents.positionX[index];
+		const float y = agents.positionY[index];
+		const uint32 avoids = agents.groupsToAvoid[index];
+
+		for (int32 j = 0; j < agents.Num() && count < LANE_AVOIDANCE_MAX_NEIGHBORS; j++)
+		{
+			if (j == index || (avoids & agents.avoidanceGroup[j]) == 0)
+				continue;
+
+			const float dx = agents.positionX[j] - x;
+			const float dy = agents.positionY[j] - y;
+			if (dx * dx + dy * dy > neighborRadiusSq)
+				continue;
+
+			//relative to the agent: where the neighbor is, and how fast the agent closes on it if it takes its preferred velocity
+			positionX[count] = dx;
+			positionY[count] = dy;
+			velocityX[count] = agents.preferredX[index] - agents.velocityX[j];
+			velocityY[count] = agents.preferredY[index] - agents.velocityY[j];
+			radius[count] = agents.radius[index] + agents.radius[j];
+			count++;
+		}
+
+		//far away, motionless and sizeless, so padding never contributes
+		const int32 padded = Align(count, 4);
+		for (int32 j = count; j < padded; j++)
+		{
+			positionX[j] = BIG_NUMBER;
+			positionY[j] = BIG_NUMBER;
+			velocityX[j] = 0.f;
+			velocityY[j] = 0.f;
+			radius[j] = 0.f;
+		}
+	}
+};
+
+int32 FLaneAvoidanceAgents::Add(AGameCharacter* character, float inRadius, float inMaxSpeed, uint32 inAvoidanceGroup, uint32 inGroupsToAvoid)
+{
+	const FVector location = character ? character->GetActorLocation() : FVector::ZeroVector;
+
+	positionX.Add(location.X);
+	positionY.Add(location.Y);
+	velocityX.Add(0.f);
+	velocityY.Add(0.f);
+	preferredX.Add(0.f);
+	preferredY.Add(0.f);
+	steerX.Add(0.f);
+	steerY.Add(0.f);
+	radius.Add(inRadius);
+	maxSpeed.Add(inMaxSpeed);
+	avoidanceGroup.Add(inAvoidanceGroup);
+	groupsToAvoid.Add(inGroupsToAvoid);
+	return characters.Add(character);
+}
+
+void FLaneAvoidanceAgents::RemoveAtSwap(int32 index)
+{
+	positionX.RemoveAtSwap(index);
+	positionY.RemoveAtSwap(index);
+	velocityX.RemoveAtSwap(index);
+	velocityY.RemoveAtSwap(index);
+	preferredX.RemoveAtSwap(index);
+	preferredY.RemoveAtSwap(index);
+	steerX.RemoveAtSwap(index);
+	steerY.RemoveAtSwap(index);
+	radius.RemoveAtSwap(index);
+	maxSpeed.RemoveAtSwap(index);
+	avoidanceGroup.RemoveAtSwap(index);
+	groupsToAvoid.RemoveAtSwap(index);
+	characters.RemoveAtSwap(index);
+}
+
+void FLaneAvoidanceAgents::SolveAgent(int32 index, const FLaneAvoidanceParams& params)
+{
+	FLaneAvoidanceNeighbors neighbors;
+	neighbors.Gather(*this, index, FMath::Square(params.neighborRadius));
+
+	const VectorRegister zero = VectorZero();
+	const VectorRegister one = VectorOne();
+	const VectorRegister epsilon = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister horizon = VectorSetFloat1(params.timeHorizon);
+	const VectorRegister invHorizon = VectorSetFloat1(1.f / params.timeHorizon);
+
+	VectorRegister sumX = zero;
+	VectorRegister sumY = zero;
+
+	for (int32 j = 0; j < neighbors.count; j += 4)
+	{
+		const VectorRegister px = VectorLoadAligned(&neighbors.positionX[j]);
+		const VectorRegister py = VectorLoadAligned(&neighbors.positionY[j]);
+		const VectorRegister wx = VectorLoadAligned(&neighbors.velocityX[j]);
+		const VectorRegister wy = VectorLoadAligned(&neighbors.velocityY[j]);
+		const VectorRegister r = VectorLoadAligned(&neighbors.radius[j]);
+
+		//the neighbor is at p - w t, they touch when that's r long: a t^2 - 2 b t + c = 0
+		const VectorRegister a = VectorMultiplyAdd(wx, wx, VectorMultiply(wy, wy));
+		const VectorRegister b = VectorMultiplyAdd(px, wx, VectorMultiply(py, wy));
+		const VectorRegister c = VectorSubtract(VectorMultiplyAdd(px, px, VectorMultiply(py, py)), VectorMultiply(r, r));
+		const VectorRegister discriminant = VectorSubtract(VectorMultiply(b, b), VectorMultiply(a, c));
+
+		const VectorRegister safeDiscriminant = VectorMax(discriminant, epsilon);
+		const VectorRegister rootDiscriminant = VectorMultiply(safeDiscriminant, VectorReciprocalSqrt(safeDiscriminant));
+		const VectorRegister timeToCollision = VectorMultiply(VectorSubtract(b, rootDiscriminant), VectorReciprocal(VectorMax(a, epsilon)));
+
+		//already overlapping, or closing and touching inside the horizon
+		const VectorRegister overlapping = VectorCompareGT(zero, c);
+		const VectorRegister approaching = VectorBitwiseAnd(VectorCompareGT(b, zero), VectorBitwiseAnd(VectorCompareGT(discriminant, zero), VectorCompareGT(horizon, timeToCollision)));
+
+		//steer away from where the neighbor will be when they touch, or straight away from it if they already are
+		const VectorRegister dx = VectorSelect(overlapping, px, VectorSubtract(px, VectorMultiply(wx, timeToCollision)));
+		const VectorRegister dy = VectorSelect(overlapping, py, VectorSubtract(py, VectorMultiply(wy, timeToCollision)));
+		const VectorRegister invLength = VectorReciprocalSqrt(VectorMax(VectorMultiplyAdd(dx, dx, VectorMultiply(dy, dy)), epsilon));
+
+		VectorRegister strength = VectorSelect(overlapping, one, VectorMultiply(VectorSubtract(horizon, timeToCollision), invHorizon));
+		strength = VectorSelect(VectorBitwiseOr(overlapping, approaching), strength, zero);
+
+		const VectorRegister scale = VectorMultiply(strength, invLength);
+		sumX = VectorSubtract(sumX, VectorMultiply(dx, scale));
+		sumY = VectorSubtract(sumY, VectorMultiply(dy, scale));
+	}
+
+	const float steerScale = params.reciprocity * maxSpeed[index];
+	steerX[index] = (VectorGetComponent(sumX, 0) + VectorGetComponent(sumX, 1) + VectorGetComponent(sumX, 2) + VectorGetComponent(sumX, 3)) * steerScale;
+	steerY[index] = (VectorGetComponent(sumY, 0) + VectorGetComponent(sumY, 1) + VectorGetComponent(sumY, 2) + VectorGetComponent(sumY, 3)) * steerScale;
+}
+
+void FLaneAvoidanceAgents::SolveAgentScalar(int32 index, const FLaneAvoidanceParams& params)
+{
+	FLaneAvoidanceNeighbors neighbors;
+	neighbors.Gather(*this, index, FMath::Square(params.neighborRadius));
+
+	float sumX = 0.f;
+	float sumY = 0.f;
+
+	for (int32 j = 0; j < neighbors.count; j++)
+	{
+		const float px = neighbors.positionX[j];
+		const float py = neighbors.positionY[j];
+		const float wx = neighbors.velocityX[j];
+		const float wy = neighbors.velocityY[j];
+		const float r = neighbors.radius[j];
+
+		const float a = wx * wx + wy * wy;
+		const float b = px * wx + py * wy;
+		const float c = px * px + py * py - r * r;
+		const float discriminant = b * b - a * c;
+
+		float dx = px;
+		float dy = py;
+		float strength = 1.f;
+
+		if (c >= 0.f)
+		{
+			if (b <= 0.f || discriminant <= 0.f || a <= KINDA_SMALL_NUMBER)
+				continue;
+
+			const float timeToCollision = (b - FMath::Sqrt(discriminant)) / a;
+			if (timeToCollision >= params.timeHorizon)
+				continue;
+
+			dx = px - wx * timeToCollision;
+			dy = py - wy * timeToCollision;
+			strength = (params.timeHorizon - timeToCollision) / params.timeHorizon;
+		}
+
+		const float invLength = FMath::InvSqrt(FMath::Max(dx * dx + dy * dy, KINDA_SMALL_NUMBER));
+		sumX -= dx * strength * invLength;
+		sumY -= dy * strength * invLength;
+	}
+
+	steerX[index] = sumX * params.reciprocity * maxSpeed[index];
+	steerY[index] = sumY * params.reciprocity * maxSpeed[index];
+}
+
+URealmLaneAvoidance::URealmLaneAvoidance(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	gameOwner = nullptr;
+	nextLane = 0;
+	maxAgentsPerUpdate = 64;
+}
+
+bool URealmLaneAvoidance::IsEnabled()
+{
+	return CVarLaneAvoidance.GetValueOnGameThread() != 0;
+}
+
+void URealmLaneAvoidance::AddAgent(AGameCharacter* character, ALaneManager* lane)
+{
+	if (!IsValid(character) || !IsValid(lane))
+		return;
+
+	URealmCharacterMovementComponent* movement = Cast<URealmCharacterMovementComponent>(character->GetCharacterMovement());
+	if (!IsValid(movement) || movement->laneAvoidance)
+		return;
+
+	//both teams' halves of a lane share one set of agents
+	ALaneManager* key = (IsValid(lane->enemyLane) && lane->enemyLane < lane) ? lane->enemyLane : lane;
+
+	int32 laneIndex = laneKeys.Find(key);
+	if (laneIndex == INDEX_NONE)
+	{
+		laneIndex = laneKeys.Add(key);
+		lanes.AddDefaulted();
+	}
+
+	const uint32 teamGroup = 1 << (character->GetTeamIndex() & 31);
+	const int32 agentIndex = lanes[laneIndex].Add(character, character->GetCapsuleComponent()->GetScaledCapsuleRadius(), movement->GetMaxSpeed(), teamGroup, teamGroup);
+
+	movement->laneAvoidance = this;
+	movement->avoidanceLane = laneIndex;
+	movement->avoidanceAgent = agentIndex;
+}
+
+void URealmLaneAvoidance::GatherAgents(FLaneAvoidanceAgents& lane)
+{
+	for (int32 i = lane.Num() - 1; i >= 0; i--)
+	{
+		AGameCharacter* character = lane.characters[i].Get();
+		if (!IsValid(character) || !character->IsAlive())
+		{
+			if (IsValid(character))
+			{
+				URealmCharacterMovementComponent* movement = Cast<URealmCharacterMovementComponent>(character->GetCharacterMovement());
+				if (IsValid(movement))
+					movement->laneAvoidance = nullptr;
+			}
+
+			lane.RemoveAtSwap(i);
+
+			//the last agent moved into this slot
+			if (i < lane.Num())
+			{
+				AGameCharacter* moved = lane.characters[i].Get();
+				URealmCharacterMovementComponent* movement = IsValid(moved) ? Cast<URealmCharacterMovementComponent>(moved->GetCharacterMovement()) : nullptr;
+				if (IsValid(movement))
+					movement->avoidanceAgent = i;
+			}
+
+			continue;
+		}
+
+		const FVector location = character->GetActorLocation();
+		const FVector velocity = character->GetVelocity();
+
+		lane.positionX[i] = location.X;
+		lane.positionY[i] = location.Y;
+		lane.velocityX[i] = velocity.X;
+		lane.velocityY[i] = velocity.Y;
+		lane.maxSpeed[i] = character->GetCharacterMovement()->GetMaxSpeed();
+	}
+}
+
+void URealmLaneAvoidance::UpdateAvoidance()
+{
+	if (lanes.Num() == 0)
+		return;
+
+	int32 agentCount = 0;
+	{
+		SCOPE_CYCLE_COUNTER(STAT_RealmLaneAvoidanceGather);
+
+		for (FLaneAvoidanceAgents& lane : lanes)
+		{
+			GatherAgents(lane);
+			agentCount += lane.Num();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_RealmLaneAvoidanceAgents, agentCount);
+
+	SCOPE_CYCLE_COUNTER(STAT_RealmLaneAvoidanceSolve);
+
+	int32 budget = maxAgentsPerUpdate;
+	for (int32 l = 0; l < lanes.Num() && budget > 0; l++)
+	{
+		FLaneAvoidanceAgents& lane = lanes[(nextLane + l) % lanes.Num()];
+		const int32 count = FMath::Min(budget, lane.Num());
+
+		for (int32 i = 0; i < count; i++)
+		{
+			if (lane.nextAgent >= lane.Num())
+				lane.nextAgent = 0;
+
+			lane.SolveAgent(lane.nextAgent++, params);
+		}
+
+		budget -= count;
+	}
+
+	nextLane = (nextLane + 1) % lanes.Num();
+}
+
+FVector URealmLaneAvoidance::ApplyAvoidance(int32 laneIndex, int32 agentIndex, const FVector& preferredVelocity)
+{
+	if (!lanes.IsValidIndex(laneIndex) || !lanes[laneIndex].positionX.IsValidIndex(agentIndex))
+		return preferredVelocity;
+
+	FLaneAvoidanceAgents& lane = lanes[laneIndex];
+
+	//path following asks for whatever gets it to the next point this frame, solve against what the agent can actually do
+	FVector2D preferred(preferredVelocity);
+	if (preferred.SizeSquared() > FMath::Square(lane.maxSpeed[agentIndex]))
+		preferred = preferred.GetSafeNormal() * lane.maxSpeed[agentIndex];
+
+	lane.preferredX[agentIndex] = preferred.X;
+	lane.preferredY[agentIndex] = preferred.Y;
+
+	FVector2D avoided = preferred + FVector2D(lane.steerX[agentIndex], lane.steerY[agentIndex]);
+	if (avoided.SizeSquared() > FMath::Square(lane.maxSpeed[agentIndex]))
+		avoided = avoided.GetSafeNormal() * lane.maxSpeed[agentIndex];
+
+	return FVector(avoided.X, avoided.Y, preferredVelocity.Z);
+}
+
+/* builds two opposing waves in a lane sized strip for the benchmark */
+static void BuildBenchmarkLane(FLaneAvoidanceAgents& lane, int32 agentCount)
+{
+	FRandomStream random(1337);
+
+	for (int32 i = 0; i < agentCount; i++)
+	{
+		const int32 team = i % 2;
+		const int32 index = lane.Add(nullptr, 45.f, 350.f, 1 << team, 1 << team);
+
+		lane.positionX[index] = random.FRandRange(0.f, 1500.f) + team * 1000.f;
+		lane.positionY[index] = random.FRandRange(-300.f, 300.f);
+		lane.velocityX[index] = team == 0 ? 300.f : -300.f;
+		lane.velocityY[index] = 0.f;
+		lane.preferredX[index] = lane.velocityX[index];
+		lane.preferredY[index] = 0.f;
+	}
+}
+
+/* realm.LaneAvoidance.Benchmark [agents] [frames] */
+static FAutoConsoleCommand LaneAvoidanceBenchmarkCommand(
+	TEXT("realm.LaneAvoidance.Benchmark"),
+	TEXT("Times the lane avoidance solve against the same agents run one at a time and through detour's crowd avoidance query. Args: [agents] [frames]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args)
+	{
+		const int32 agentCount = FMath::Max(2, args.Num() > 0 ? FCString::Atoi(*args[0]) : 60);
+		const int32 frames = FMath::Max(1, args.Num() > 1 ? FCString::Atoi(*args[1]) : 200);
+
+		FLaneAvoidanceParams params;
+		FLaneAvoidanceAgents lane;
+		BuildBenchmarkLane(lane, agentCount);
+
+		double startTime = FPlatformTime::Seconds();
+		for (int32 f = 0; f < frames; f++)
+		{
+			for (int32 i = 0; i < lane.Num(); i++)
+				lane.SolveAgent(i, params);
+		}
+		const double simdTime = FPlatformTime::Seconds() - startTime;
+
+		startTime = FPlatformTime::Seconds();
+		for (int32 f = 0; f < frames; f++)
+		{
+			for (int32 i = 0; i < lane.Num(); i++)
+				lane.SolveAgentScalar(i, params);
+		}
+		const double scalarTime = FPlatformTime::Seconds() - startTime;
+
+		UE_LOG(LogTemp, Warning, TEXT("lane avoidance benchmark, %d agents over %d frames"), agentCount, frames);
+		UE_LOG(LogTemp, Warning, TEXT("  batched simd:   %.4f ms per frame"), simdTime * 1000.0 / frames);
+		UE_LOG(LogTemp, Warning, TEXT("  batched scalar: %.4f ms per frame"), scalarTime * 1000.0 / frames);
+
+#if WITH_RECAST
+		//what the crowd simulation does per agent at medium quality, with the same neighbors
+		dtObstacleAvoidanceQuery* query = dtAllocObstacleAvoidanceQuery();
+		query->init(LANE_AVOIDANCE_MAX_NEIGHBORS, 0, 0);
+
+		dtObstacleAvoidanceParams avoidanceParams;
+		FMemory::Memzero(avoidanceParams);
+		avoidanceParams.velBias = 0.5f;
+		avoidanceParams.weightDesVel = 2.f;
+		avoidanceParams.weightCurVel = 0.75f;
+		avoidanceParams.weightSide = 0.75f;
+		avoidanceParams.weightToi = 2.5f;
+		avoidanceParams.horizTime = 2.5f;
+		avoidanceParams.gridSize = 33;
+		avoidanceParams.adaptiveDivs = 5;
+		avoidanceParams.adaptiveRings = 2;
+		avoidanceParams.adaptiveDepth = 2;
+
+		const float neighborRadiusSq = FMath::Square(params.neighborRadius);
+
+		startTime = FPlatformTime::Seconds();
+		for (int32 f = 0; f < frames; f++)
+		{
+			for (int32 i = 0; i < lane.Num(); i++)
+			{
+				query->reset();
+
+				int32 neighborCount = 0;
+				for (int32 j = 0; j < lane.Num() && neighborCount < LANE_AVOIDANCE_MAX_NEIGHBORS; j++)
+				{
+					if (j == i || (lane.groupsToAvoid[i] & lane.avoidanceGroup[j]) == 0)
+						continue;
+
+					if (FMath::Square(lane.positionX[j] - lane.positionX[i]) + FMath::Square(lane.positionY[j] - lane.positionY[i]) > neighborRadiusSq)
+						continue;
+
+					//detour is y up
+					const float position[3] = { lane.positionX[j], 0.f, lane.positionY[j] };
+					const float velocity[3] = { lane.velocityX[j], 0.f, lane.velocityY[j] };
+					query->addCircle(position, lane.radius[j], velocity, velocity);
+					neighborCount++;
+				}
+
+				const float position[3] = { lane.positionX[i], 0.f, lane.positionY[i] };
+				const float velocity[3] = { lane.velocityX[i], 0.f, lane.velocityY[i] };
+				const float preferred[3] = { lane.preferredX[i], 0.f, lane.preferredY[i] };
+				float solved[3];
+				query->sampleVelocityAdaptive(position, lane.radius[i], lane.maxSpeed[i], velocity, preferred, solved, &avoidanceParams);
+			}
+		}
+		const double crowdTime = FPlatformTime::Seconds() - startTime;
+
+		dtFreeObstacleAvoidanceQuery(query);
+
+		UE_LOG(LogTemp, Warning, TEXT("  detour crowd:   %.4f ms per frame"), crowdTime * 1000.0 / frames);
+#endif
+	}));
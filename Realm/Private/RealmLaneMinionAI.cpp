@@ -5,12 +5,24 @@
 #include "RealmObjective.h"
 #include "PlayerCharacter.h"
 #include "RealmTurret.h"
+#include "RealmGameMode.h"
+#include "RealmCrowdComponent.h"
+#include "RealmLaneAvoidance.h"
 
 ARealmLaneMinionAI::ARealmLaneMinionAI(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
 	aggroDistance = 420.f;
 	targetRadius->SightRadius = aggroDistance;
+
+	bUsesSignificance = true;
+}
+
+void ARealmLaneMinionAI::OnSignificanceChanged(ERealmSignificance oldSignificance)
+{
+	Super::OnSignificanceChanged(oldSignificance);
+
+	RescaleRepeatingTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, SignificanceReevaluationScale[(uint8)oldSignificance]);
 }
 
 void ARealmLaneMinionAI::Possess(APawn* InPawn)
@@ -27,6 +39,15 @@ void ARealmLaneMinionAI::Possess(APawn* InPawn)
 	for (int32 i = 0; i < laneManager->enemyLane->laneObjectives.Num(); i++)
 		objectives.Enqueue(laneManager->enemyLane->laneObjectives[i]);
 
+	//hand avoidance over to the lane solver while the path following is still idle, the crowd won't switch off mid move
+	ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+	URealmCrowdComponent* cc = Cast<URealmCrowdComponent>(GetPathFollowingComponent());
+	if (URealmLaneAvoidance::IsEnabled() && IsValid(mc) && IsValid(cc) && IsValid(gm) && IsValid(gm->laneAvoidance))
+	{
+		cc->SetCrowdSimulation(false);
+		gm->laneAvoidance->AddAgent(mc, laneManager);
+	}
+
 	objectives.Dequeue(objectiveTarget);
 	MoveToActor(objectiveTarget);
 	currentTargetPriority = ELaneMinionTargetPriority::LMTP_ObjectiveTarget;
@@ -83,7 +104,7 @@ void ARealmLaneMinionAI::OnTargetEnterRadius(class APawn* pawn)
 				SetNewTarget(gc, priority);
 				minionCharacter->StartAutoAttack();
 
-				GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.33f, true);
+				GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.33f * GetReevaluationScale(), true);
 
 				return;
 			}
@@ -109,7 +130,7 @@ void ARealmLaneMinionAI::OnTargetEnterRadius(class APawn* pawn)
 		SetNewTarget(gc, priority);
 		minionCharacter->StartAutoAttack();
 
-		GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.33f, true);
+		GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.33f * GetReevaluationScale(), true);
 	}
 }
 
@@ -434,7 +455,7 @@ void ARealmLaneMinionAI::CharacterInAttackRange()
 			minionCharacter->StopAutoAttack();
 			MoveToLocation(minionCharacter->GetActorLocation() + (newLoc.Rotation().Vector() * 25.f));
 
-			GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.8f, true);
+			GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmLaneMinionAI::ReevaluateTargets, 0.8f * GetReevaluationScale(), true);
 
 			return;
 		}
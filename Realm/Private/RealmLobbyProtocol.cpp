@@ -0,0 +1,141 @@
+#include "Realm.h"
+#include "RealmLobbyProtocol.h"
+
+/* size of the frame header after the length: message id, correlation id, field count */
+static const int32 FRAME_HEADER_SIZE = 1 + 4 + 1;
+
+static void WriteUInt16(TArray<uint8>& data, uint16 value)
+{
+	data.Add(value & 0xFF);
+	data.Add((value >> 8) & 0xFF);
+}
+
+static void WriteUInt32(TArray<uint8>& data, uint32 value)
+{
+	data.Add(value & 0xFF);
+	data.Add((value >> 8) & 0xFF);
+	data.Add((value >> 16) & 0xFF);
+	data.Add((value >> 24) & 0xFF);
+}
+
+static uint16 ReadUInt16(const uint8* data)
+{
+	return (uint16)data[0] | ((uint16)data[1] << 8);
+}
+
+static uint32 ReadUInt32(const uint8* data)
+{
+	return (uint32)data[0] | ((uint32)data[1] << 8) | ((uint32)data[2] << 16) | ((uint32)data[3] << 24);
+}
+
+FLobbyMessage& FLobbyMessage::AddString(const FString& value)
+{
+	FTCHARToUTF8 utf8(*value);
+
+	TArray<uint8>& field = fields[fields.AddDefaulted()];
+	field.Append((const uint8*)utf8.Get(), FMath::Min(utf8.Length(), (int32)MAX_uint16));
+	return *this;
+}
+
+FLobbyMessage& FLobbyMessage::AddInt(int32 value)
+{
+	TArray<uint8>& field = fields[fields.AddDefaulted()];
+	WriteUInt32(field, (uint32)value);
+	return *this;
+}
+
+FString FLobbyMessage::GetString(int32 index) const
+{
+	if (!fields.IsValidIndex(index) || fields[index].Num() == 0)
+		return FString();
+
+	FUTF8ToTCHAR converted((const ANSICHAR*)fields[index].GetData(), fields[index].Num());
+	return FString(converted.Length(), converted.Get());
+}
+
+int32 FLobbyMessage::GetInt(int32 index) const
+{
+	if (!fields.IsValidIndex(index) || fields[index].Num() != 4)
+		return 0;
+
+	return (int32)ReadUInt32(fields[index].GetData());
+}
+
+void FLobbyCodec::Encode(const FLobbyMessage& message, TArray<uint8>& outData)
+{
+	const int32 fieldCount = FMath::Min(message.fields.Num(), (int32)MAX_uint8);
+
+	uint32 frameLength = FRAME_HEADER_SIZE;
+	for (int32 i = 0; i < fieldCount; i++)
+		frameLength += 2 + message.fields[i].Num();
+
+	outData.Reset(frameLength + 4);
+	WriteUInt32(outData, frameLength);
+	outData.Add((uint8)message.messageId);
+	WriteUInt32(outData, message.correlationId);
+	outData.Add((uint8)fieldCount);
+
+	for (int32 i = 0; i < fieldCount; i++)
+	{
+		WriteUInt16(outData, (uint16)message.fields[i].Num());
+		outData.Append(message.fields[i]);
+	}
+}
+
+void FLobbyCodec::AppendData(const uint8* data, int32 num)
+{
+	if (num > 0)
+		streamBuffer.Append(data, num);
+}
+
+bool FLobbyCodec::NextMessage(FLobbyMessage& outMessage)
+{
+	if (bCorrupt || streamBuffer.Num() < 4)
+		return false;
+
+	const uint32 frameLength = ReadUInt32(streamBuffer.GetData());
+	if (frameLength < FRAME_HEADER_SIZE || frameLength > MaxFrameSize)
+	{
+		bCorrupt = true;
+		return false;
+	}
+
+	//wait for the rest of the frame
+	if ((uint32)streamBuffer.Num() < frameLength + 4)
+		return false;
+
+	const uint8* frame = streamBuffer.GetData() + 4;
+	const uint8* frameEnd = frame + frameLength;
+
+	outMessage.messageId = (ELobbyMessage)frame[0];
+	outMessage.correlationId = ReadUInt32(frame + 1);
+	const int32 fieldCount = frame[5];
+
+	outMessage.fields.Reset(fieldCount);
+
+	const uint8* cursor = frame + FRAME_HEADER_SIZE;
+	for (int32 i = 0; i < fieldCount; i++)
+	{
+		if (cursor + 2 > frameEnd)
+		{
+			bCorrupt = true;
+			return false;
+		}
+
+		const uint16 fieldLength = ReadUInt16(cursor);
+		cursor += 2;
+
+		if (cursor + fieldLength > frameEnd)
+		{
+			bCorrupt = true;
+			return false;
+		}
+
+		TArray<uint8>& field = outMessage.fields[outMessage.fields.AddDefaulted()];
+		field.Append(cursor, fieldLength);
+		cursor += fieldLength;
+	}
+
+	streamBuffer.RemoveAt(0, frameLength + 4, false);
+	return true;
+}
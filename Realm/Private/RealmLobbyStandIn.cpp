@@ -0,0 +1,616 @@
+#include "Realm.h"
+#include "RealmLobbyStandIn.h"
+#include "RealmSocketListener.h"
+
+static FRealmLobbyStandIn* GLobbyStandIn = nullptr;
+static FRealmLobbyLoadTest* GLobbyLoadTest = nullptr;
+
+/* address handed out for confirmed matches, nothing has to be listening there */
+static const FString STANDIN_MATCH_ADDRESS = TEXT("127.0.0.1:7777");
+
+/* most simulated clients a single load test will create, each one is a listener with its own thread */
+static const int32 MAX_LOAD_TEST_CLIENTS = 512;
+
+/* most unsent bytes a connection can back up before it's dropped */
+static const int32 MAX_SEND_BUFFER_SIZE = 1024 * 1024;
+
+const double FRealmLobbyLoadTest::RequestTimeout = 5.0;
+const double FRealmLobbyLoadTest::ConnectTimeout = 10.0;
+
+/* reads everything waiting on a socket into its codec, returns false if the connection failed */
+static bool ReceiveLobbyData(FSocket* socket, FLobbyCodec& codec)
+{
+	TArray<uint8> receivedData;
+
+	uint32 size;
+	while (socket->HasPendingData(size))
+	{
+		receivedData.SetNumUninitialized(FMath::Min(size, 65507u));
+
+		int32 read = 0;
+		if (!socket->Recv(receivedData.GetData(), receivedData.Num(), read))
+			return false;
+
+		codec.AppendData(receivedData.GetData(), read);
+	}
+
+	return true;
+}
+
+/* sends as much of the buffer as a non-blocking socket takes and keeps the rest for next time, so a partial send never
+   leaves half a frame in the stream. returns false if the connection failed or has backed up too far */
+static bool FlushLobbySendBuffer(FSocket* socket, TArray<uint8>& sendBuffer)
+{
+	while (sendBuffer.Num() > 0)
+	{
+		int32 sent = 0;
+		if (!socket->Send(sendBuffer.GetData(), sendBuffer.Num(), sent))
+		{
+			if (ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() != SE_EWOULDBLOCK)
+				return false;
+
+			sent = 0;
+		}
+
+		if (sent <= 0)
+			break;
+
+		sendBuffer.RemoveAt(0, sent, false);
+	}
+
+	return sendBuffer.Num() <= MAX_SEND_BUFFER_SIZE;
+}
+
+FRealmLobbyStandIn::FRealmLobbyStandIn(const TArray<int32>& ports, int32 inFailPercent, float inMatchDelay)
+{
+	failPercent = FMath::Clamp(inFailPercent, 0, 100);
+	matchDelay = FMath::Max(inMatchDelay, 0.f);
+	random.GenerateNewSeed();
+	serverThread = nullptr;
+
+	for (int32 port : ports)
+	{
+		FSocket* listenSocket = FTcpSocketBuilder(TEXT("lobby stand-in"))
+			.AsReusable()
+			.AsNonBlocking()
+			.BoundToPort(port)
+			.Listening(128)
+			.Build();
+
+		if (!listenSocket)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("lobby stand-in couldn't listen on port %d"), port);
+			CloseAll();
+			return;
+		}
+
+		listenSockets.Add(listenSocket);
+	}
+
+	serverThread = FRunnableThread::Create(this, TEXT("FRealmLobbyStandIn"), 0, TPri_BelowNormal);
+}
+
+FRealmLobbyStandIn::~FRealmLobbyStandIn()
+{
+	EnsureCompletion();
+
+	delete serverThread;
+	serverThread = nullptr;
+
+	CloseAll();
+}
+
+void FRealmLobbyStandIn::CloseAll()
+{
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	for (FStandInClient* client : clients)
+	{
+		client->socket->Close();
+		socketSubsystem->DestroySocket(client->socket);
+		delete client;
+	}
+	clients.Empty();
+
+	for (FSocket* listenSocket : listenSockets)
+	{
+		listenSocket->Close();
+		socketSubsystem->DestroySocket(listenSocket);
+	}
+	listenSockets.Empty();
+}
+
+void FRealmLobbyStandIn::AcceptConnections()
+{
+	for (FSocket* listenSocket : listenSockets)
+	{
+		bool bPending = false;
+		while (listenSocket->HasPendingConnection(bPending) && bPending)
+		{
+			FSocket* clientSocket = listenSocket->Accept(TEXT("lobby stand-in client"));
+			if (!clientSocket)
+				break;
+
+			clientSocket->SetNonBlocking(true);
+
+			FStandInClient* client = new FStandInClient();
+			client->socket = clientSocket;
+			clients.Add(client);
+
+			connectionsAccepted.Increment();
+		}
+	}
+}
+
+bool FRealmLobbyStandIn::ServiceClient(FStandInClient& client)
+{
+	if (client.socket->GetConnectionState() == SCS_ConnectionError)
+		return false;
+
+	//whatever didn't fit last time goes out before any new responses
+	if (!FlushLobbySendBuffer(client.socket, client.sendBuffer))
+		return false;
+
+	if (!ReceiveLobbyData(client.socket, client.codec))
+		return false;
+
+	FLobbyMessage request;
+	while (client.codec.NextMessage(request))
+	{
+		if (!HandleRequest(client, request))
+			return false;
+	}
+
+	if (client.codec.IsCorrupt())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("lobby stand-in received a malformed message, dropping the client"));
+		return false;
+	}
+
+	//matches are pushed on their own, like the real matchmaker does
+	if (client.matchPushTime > 0.0 && FPlatformTime::Seconds() >= client.matchPushTime)
+	{
+		client.matchPushTime = 0.0;
+
+		FLobbyMessage foundMatch(ELobbyMessage::FoundMatch);
+		foundMatch.AddString(FString::Printf(TEXT("standin_match_%d"), random.RandHelper(MAX_int32)));
+		if (!SendMessage(client, foundMatch))
+			return false;
+	}
+
+	return true;
+}
+
+bool FRealmLobbyStandIn::ShouldFail()
+{
+	return failPercent > 0 && random.RandHelper(100) < failPercent;
+}
+
+bool FRealmLobbyStandIn::HandleRequest(FStandInClient& client, const FLobbyMessage& request)
+{
+	requestsHandled.Increment();
+
+	//responses answer the request they came from
+	FLobbyMessage response(ELobbyMessage::None, request.correlationId);
+
+	switch (request.messageId)
+	{
+	case ELobbyMessage::Login:
+		if (ShouldFail())
+			response.messageId = ELobbyMessage::LoginFailure;
+		else
+		{
+			//userid, experience, mythos points, alias
+			response.messageId = ELobbyMessage::LoginSuccess;
+			response.AddString(TEXT("standin_") + request.GetString(0)).AddInt(0).AddInt(100).AddString(request.GetString(0));
+		}
+		break;
+	case ELobbyMessage::LoginCreate:
+		if (ShouldFail())
+		{
+			response.messageId = ELobbyMessage::CreateLoginFailure;
+			response.AddString(TEXT("rejected by the stand-in server"));
+		}
+		else
+			response.messageId = ELobbyMessage::CreateLoginSuccess;
+		break;
+	case ELobbyMessage::GetInfoUpdate:
+		//alias, mythos points
+		response.messageId = ELobbyMessage::UpdateInfo;
+		response.AddString(request.GetString(0)).AddInt(100);
+		break;
+	case ELobbyMessage::JoinQueue:
+		if (ShouldFail())
+			response.messageId = ELobbyMessage::JoinedQueueFailed;
+		else
+		{
+			response.messageId = ELobbyMessage::JoinedQueueSuccessfully;
+			client.matchPushTime = FPlatformTime::Seconds() + FMath::Max(matchDelay, KINDA_SMALL_NUMBER);
+		}
+		break;
+	case ELobbyMessage::ConfirmMatch:
+		if (ShouldFail())
+			response.messageId = ELobbyMessage::MatchConfirmFailed;
+		else
+		{
+			response.messageId = ELobbyMessage::FoundMatchConfirmed;
+			response.AddString(STANDIN_MATCH_ADDRESS);
+		}
+		break;
+	default:
+		//ranked results and anything unknown don't get an answer
+		return true;
+	}
+
+	return SendMessage(client, response);
+}
+
+bool FRealmLobbyStandIn::SendMessage(FStandInClient& client, const FLobbyMessage& message)
+{
+	TArray<uint8> data;
+	FLobbyCodec::Encode(message, data);
+	client.sendBuffer.Append(data);
+
+	return FlushLobbySendBuffer(client.socket, client.sendBuffer);
+}
+
+uint32 FRealmLobbyStandIn::Run()
+{
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	while (stopServerThread.GetValue() == 0)
+	{
+		AcceptConnections();
+
+		for (int32 i = clients.Num() - 1; i >= 0; i--)
+		{
+			if (!ServiceClient(*clients[i]))
+			{
+				clients[i]->socket->Close();
+				socketSubsystem->DestroySocket(clients[i]->socket);
+				delete clients[i];
+				clients.RemoveAtSwap(i);
+			}
+		}
+
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	return 0;
+}
+
+void FRealmLobbyStandIn::Stop()
+{
+	stopServerThread.Increment();
+}
+
+void FRealmLobbyStandIn::EnsureCompletion()
+{
+	Stop();
+
+	if (serverThread)
+		serverThread->WaitForCompletion();
+}
+
+FRealmLobbyLoadTest::FRealmLobbyLoadTest(const FString& inHost, int32 inPort, int32 inClientCount, float inDuration)
+{
+	host = inHost;
+	port = inPort;
+	clientCount = FMath::Clamp(inClientCount, 1, MAX_LOAD_TEST_CLIENTS);
+	duration = FMath::Max(inDuration, 1.f);
+	nextCorrelationId = 1;
+	failedResponses = 0;
+	pushedMessages = 0;
+	timedOutRequests = 0;
+	droppedClients = 0;
+
+	testThread = FRunnableThread::Create(this, TEXT("FRealmLobbyLoadTest"), 0, TPri_BelowNormal);
+}
+
+FRealmLobbyLoadTest::~FRealmLobbyLoadTest()
+{
+	EnsureCompletion();
+
+	delete testThread;
+	testThread = nullptr;
+}
+
+void FRealmLobbyLoadTest::CloseClient(FLoadTestClient& client)
+{
+	if (client.listener)
+	{
+		client.listener->EnsureCompletion();
+		delete client.listener;
+		client.listener = nullptr;
+	}
+
+	client.pendingCorrelationId = 0;
+}
+
+int32 FRealmLobbyLoadTest::ConnectClients()
+{
+	for (FLoadTestClient& client : clients)
+		client.listener = FRealmSocketListener::CreateListener(host, port, false);
+
+	//the listeners connect on their own threads, wait for them here so the connection storm isn't measured
+	const double connectStart = FPlatformTime::Seconds();
+	int32 connectedCount = 0;
+	while (stopTestThread.GetValue() == 0 && FPlatformTime::Seconds() - connectStart < ConnectTimeout)
+	{
+		connectedCount = 0;
+		for (FLoadTestClient& client : clients)
+		{
+			if (client.listener && client.listener->IsConnected())
+				connectedCount++;
+		}
+
+		if (connectedCount == clients.Num())
+			break;
+
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	for (FLoadTestClient& client : clients)
+		client.bWasConnected = client.listener && client.listener->IsConnected();
+
+	return connectedCount;
+}
+
+void FRealmLobbyLoadTest::SendNextRequest(FLoadTestClient& client, int32 clientIndex)
+{
+	const FString username = FString::Printf(TEXT("loadtest%d"), clientIndex);
+
+	FLobbyMessage request;
+	switch (client.step)
+	{
+	case 0:
+		request.messageId = ELobbyMessage::Login;
+		request.AddString(username).AddString(TEXT("da39a3ee5e6b4b0d3255bfef95601890afd80709"));
+		break;
+	case 1:
+		request.messageId = ELobbyMessage::GetInfoUpdate;
+		request.AddString(username);
+		break;
+	case 2:
+		request.messageId = ELobbyMessage::JoinQueue;
+		request.AddString(username).AddString(TEXT("solo"));
+		break;
+	default:
+		request.messageId = ELobbyMessage::ConfirmMatch;
+		request.AddString(username).AddString(TEXT("loadtest_match"));
+		break;
+	}
+
+	//login once, then keep cycling the rest
+	client.step = client.step >= 3 ? 1 : client.step + 1;
+
+	if (nextCorrelationId == 0)
+		nextCorrelationId = 1;
+
+	request.correlationId = nextCorrelationId++;
+	client.pendingCorrelationId = request.correlationId;
+	client.sendTime = FPlatformTime::Seconds();
+
+	client.listener->Send(request);
+}
+
+uint32 FRealmLobbyLoadTest::Run()
+{
+	UE_LOG(LogTemp, Warning, TEXT("lobby load test: %d clients against %s:%d for %.0f seconds"), clientCount, *host, port, duration);
+
+	//connect everyone first so the measurement doesn't include the connection storm
+	const double connectStart = FPlatformTime::Seconds();
+	clients.SetNum(clientCount);
+	const int32 connectedCount = ConnectClients();
+	const double connectTime = FPlatformTime::Seconds() - connectStart;
+
+	if (connectedCount < clientCount)
+		UE_LOG(LogTemp, Warning, TEXT("lobby load test: only %d of %d clients connected"), connectedCount, clientCount);
+
+	const double testStart = FPlatformTime::Seconds();
+	while (stopTestThread.GetValue() == 0 && FPlatformTime::Seconds() - testStart < duration)
+	{
+		bool bAnyActivity = false;
+
+		for (int32 i = 0; i < clients.Num(); i++)
+		{
+			FLoadTestClient& client = clients[i];
+			if (!client.listener)
+				continue;
+
+			//the listener reconnects by itself, whatever was in flight is lost and will time out
+			const bool bConnected = client.listener->IsConnected();
+			if (client.bWasConnected && !bConnected)
+				droppedClients++;
+
+			client.bWasConnected = bConnected;
+
+			const double currentTime = FPlatformTime::Seconds();
+
+			FLobbyMessage message;
+			while (client.listener->GetNextMessage(message))
+			{
+				bAnyActivity = true;
+
+				if (message.correlationId == 0)
+				{
+					pushedMessages++;
+					continue;
+				}
+
+				//late answers to requests that already timed out don't count
+				if (message.correlationId != client.pendingCorrelationId)
+					continue;
+
+				latencies.Add((float)((currentTime - client.sendTime) * 1000.0));
+				client.pendingCorrelationId = 0;
+
+				if (message.messageId == ELobbyMessage::LoginFailure || message.messageId == ELobbyMessage::JoinedQueueFailed ||
+					message.messageId == ELobbyMessage::MatchConfirmFailed)
+					failedResponses++;
+			}
+
+			//a lost request would otherwise stall this client for the rest of the test
+			if (client.pendingCorrelationId != 0 && currentTime - client.sendTime > RequestTimeout)
+			{
+				timedOutRequests++;
+				client.pendingCorrelationId = 0;
+			}
+
+			//a reconnected client has to log in again
+			if (!bConnected)
+			{
+				client.step = 0;
+				continue;
+			}
+
+			if (client.pendingCorrelationId == 0)
+			{
+				bAnyActivity = true;
+				SendNextRequest(client, i);
+			}
+		}
+
+		//the listeners do the socket work, this thread only has to keep up with their queues
+		if (!bAnyActivity)
+			FPlatformProcess::Sleep(0.001f);
+	}
+
+	ReportResults(FPlatformTime::Seconds() - testStart, connectTime);
+
+	for (FLoadTestClient& client : clients)
+		CloseClient(client);
+	clients.Empty();
+
+	finished.Set(1);
+	return 0;
+}
+
+void FRealmLobbyLoadTest::ReportResults(double elapsed, double connectTime)
+{
+	if (latencies.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("lobby load test: no responses received in %.1f seconds, %d timed out requests, %d dropped clients"), elapsed, timedOutRequests, droppedClients);
+		return;
+	}
+
+	latencies.Sort();
+
+	auto percentile = [this](float p)
+	{
+		const int32 index = FMath::Clamp(FMath::CeilToInt(p * latencies.Num()) - 1, 0, latencies.Num() - 1);
+		return latencies[index];
+	};
+
+	UE_LOG(LogTemp, Warning, TEXT("lobby load test: %d responses in %.1f seconds, %.0f requests/sec, connected in %.2f seconds"),
+		latencies.Num(), elapsed, latencies.Num() / elapsed, connectTime);
+	UE_LOG(LogTemp, Warning, TEXT("lobby load test: latency ms p50 %.2f, p90 %.2f, p99 %.2f, max %.2f"),
+		percentile(0.5f), percentile(0.9f), percentile(0.99f), latencies.Last());
+	UE_LOG(LogTemp, Warning, TEXT("lobby load test: %d failure responses, %d server pushes, %d timed out requests, %d dropped clients"),
+		failedResponses, pushedMessages, timedOutRequests, droppedClients);
+}
+
+void FRealmLobbyLoadTest::Stop()
+{
+	stopTestThread.Increment();
+}
+
+void FRealmLobbyLoadTest::EnsureCompletion()
+{
+	Stop();
+
+	if (testThread)
+		testThread->WaitForCompletion();
+}
+
+static void StopLobbyStandIn();
+static void StopLobbyLoadTest();
+
+/* the tools are started from the console and can still be running when the game exits */
+static void StopLobbyTools()
+{
+	StopLobbyLoadTest();
+	StopLobbyStandIn();
+}
+
+static void BindLobbyToolsShutdown()
+{
+	static bool bBound = false;
+	if (!bBound)
+	{
+		FCoreDelegates::OnPreExit.AddStatic(&StopLobbyTools);
+		bBound = true;
+	}
+}
+
+static void StopLobbyLoadTest()
+{
+	delete GLobbyLoadTest;
+	GLobbyLoadTest = nullptr;
+}
+
+static void StopLobbyStandIn()
+{
+	if (GLobbyStandIn)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("lobby stand-in stopped after %d connections and %d requests"), GLobbyStandIn->GetConnectionsAccepted(), GLobbyStandIn->GetRequestsHandled());
+
+		delete GLobbyStandIn;
+		GLobbyStandIn = nullptr;
+	}
+}
+
+/* realm.LobbyStandIn.Start [failPercent] [matchDelay] */
+static FAutoConsoleCommand LobbyStandInStartCommand(
+	TEXT("realm.LobbyStandIn.Start"),
+	TEXT("Starts a local stand-in for the login and multiplayer servers. Args: [failPercent] [matchDelaySeconds]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args)
+	{
+		StopLobbyStandIn();
+
+		const int32 failPercent = args.Num() > 0 ? FCString::Atoi(*args[0]) : 0;
+		const float matchDelay = args.Num() > 1 ? FCString::Atof(*args[1]) : 1.f;
+
+		TArray<int32> ports;
+		ports.Add(LOGIN_PORT);
+		ports.Add(MULTIPLAYER_PORT);
+
+		BindLobbyToolsShutdown();
+		GLobbyStandIn = new FRealmLobbyStandIn(ports, failPercent, matchDelay);
+		if (!GLobbyStandIn->IsListening())
+		{
+			delete GLobbyStandIn;
+			GLobbyStandIn = nullptr;
+			return;
+		}
+
+		UE_LOG(LogTemp, Warning, TEXT("lobby stand-in listening on %d and %d, failing %d%% of requests"), LOGIN_PORT, MULTIPLAYER_PORT, failPercent);
+	}));
+
+static FAutoConsoleCommand LobbyStandInStopCommand(
+	TEXT("realm.LobbyStandIn.Stop"),
+	TEXT("Stops the local lobby stand-in server."),
+	FConsoleCommandDelegate::CreateStatic(&StopLobbyStandIn));
+
+/* realm.LobbyLoadTest [clients] [seconds] [host] [port] */
+static FAutoConsoleCommand LobbyLoadTestCommand(
+	TEXT("realm.LobbyLoadTest"),
+	TEXT("Drives simulated lobby clients against a server and logs latency percentiles and throughput. Args: [clients] [seconds] [host] [port]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args)
+	{
+		if (GLobbyLoadTest && !GLobbyLoadTest->IsFinished())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("lobby load test is already running"));
+			return;
+		}
+
+		StopLobbyLoadTest();
+
+		const int32 clientCount = args.Num() > 0 ? FCString::Atoi(*args[0]) : 256;
+		const float duration = args.Num() > 1 ? FCString::Atof(*args[1]) : 10.f;
+		const FString host = args.Num() > 2 ? args[2] : FString(TEXT("127.0.0.1"));
+		const int32 port = args.Num() > 3 ? FCString::Atoi(*args[3]) : MULTIPLAYER_PORT;
+
+		BindLobbyToolsShutdown();
+		GLobbyLoadTest = new FRealmLobbyLoadTest(host, port, clientCount, duration);
+	}));
@@ -3,6 +3,9 @@
 #include "GameCharacter.h"
 #include "RealmCrowdComponent.h"
 
+const float ARealmMoveController::SignificanceMovementTickInterval[(uint8)ERealmSignificance::RS_MAX] = { 0.f, 0.05f, 0.2f };
+const float ARealmMoveController::SignificanceReevaluationScale[(uint8)ERealmSignificance::RS_MAX] = { 1.f, 2.f, 4.f };
+
 ARealmMoveController::ARealmMoveController(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer.SetDefaultSubobjectClass<URealmCrowdComponent>(TEXT("PathFollowingComponent")))
 {
@@ -12,6 +15,53 @@ ARealmMoveController::ARealmMoveController(const FObjectInitializer& objectIniti
 	targetRadius->bOnlySensePlayers = false;
 	targetRadius->SensingInterval = 0.25f;
 	targetRadius->SetPeripheralVisionAngle(180.f);
+
+	bUsesSignificance = false;
+	significance = ERealmSignificance::RS_High;
+	baseSensingInterval = targetRadius->SensingInterval;
+}
+
+float ARealmMoveController::GetReevaluationScale() const
+{
+	return SignificanceReevaluationScale[(uint8)significance];
+}
+
+void ARealmMoveController::SetSignificance(ERealmSignificance newSignificance)
+{
+	if (newSignificance == significance || newSignificance >= ERealmSignificance::RS_MAX)
+		return;
+
+	const ERealmSignificance oldSignificance = significance;
+	significance = newSignificance;
+	OnSignificanceChanged(oldSignificance);
+}
+
+void ARealmMoveController::OnSignificanceChanged(ERealmSignificance oldSignificance)
+{
+	const uint8 tier = (uint8)significance;
+
+	ACharacter* character = GetCharacter();
+	if (IsValid(character) && character->GetCharacterMovement())
+		character->GetCharacterMovement()->PrimaryComponentTick.TickInterval = SignificanceMovementTickInterval[tier];
+
+	//units nobody is near don't need good avoidance
+	URealmCrowdComponent* cc = Cast<URealmCrowdComponent>(GetPathFollowingComponent());
+	if (IsValid(cc))
+	{
+		switch (significance)
+		{
+		case ERealmSignificance::RS_High:
+			cc->AvoidanceQuality = ECrowdAvoidanceQuality::Medium;
+			break;
+		default:
+			cc->AvoidanceQuality = ECrowdAvoidanceQuality::Low;
+			break;
+		}
+
+		cc->UpdateCrowdAgentParams();
+	}
+
+	targetRadius->SensingInterval = baseSensingInterval * SignificanceReevaluationScale[tier];
 }
 
 void ARealmMoveController::Possess(APawn* inPawn)
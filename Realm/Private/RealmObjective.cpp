@@ -15,4 +15,24 @@ void ARealmObjective::CheckDamage(FTakeHitInfo& damage)
 void ARealmObjective::GiveCharacterExperience(int32 amount)
 {
 	//don't do anything; objectives don't receive experience
+}
+
+float ARealmObjective::GetWatchedRange() const
+{
+	return 0.f;
+}
+
+bool ARealmObjective::ShouldWatchUnit(AGameCharacter* unit) const
+{
+	return false;
+}
+
+void ARealmObjective::OnUnitEnteredRange(AGameCharacter* unit)
+{
+
+}
+
+void ARealmObjective::OnUnitLeftRange(AGameCharacter* unit)
+{
+
 }
\ No newline at end of file
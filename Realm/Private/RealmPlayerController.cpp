@@ -11,12 +11,42 @@
 #include "RealmGameInstance.h"
 #include "MinimapActor.h"
 #include "RealmFogOfWarManager.h"
+#include "RealmClientSignificanceManager.h"
+#include "RealmAutoAttackScheduler.h"
+#include "RealmCharacterMovementComponent.h"
 
 ARealmPlayerController::ARealmPlayerController(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
 {
 	bShowMouseCursor = true;
 
+	lastCommandLocation = FVector::ZeroVector;
+	lastCommandTarget = nullptr;
+	lastCommandPickedActor = nullptr;
+	bHasSentCommand = false;
+	commandResendDistance = 40.f;
+
+	pursuitTarget = nullptr;
+	bInAutoAttackSchedule = false;
+
+	maxCommandsPerSecond = 20;
+	commandWindowStart = 0.f;
+	commandsThisWindow = 0;
+	pendingCommandLocation = FVector::ZeroVector;
+	pendingCommandTarget = nullptr;
+	pendingCommandPickedActor = nullptr;
+	pendingCommandId = 0;
+	bHasPendingCommand = false;
+
+	sentCommandCount = 0;
+	acknowledgedCommand = 0;
+	rejectedCommand = 0;
+
+	maxChatsPerInterval = 4;
+	chatInterval = 4.f;
+	chatWindowStart = 0.f;
+	chatsThisWindow = 0;
+
 	//debug code
 	//static ConstructorHelpers::FClassFinder<APlayerCharacter> PlayerPawnBPClass(TEXT("/Game/Realm/Characters/PCs/Leighton/Leighton"));
 	//if (PlayerPawnBPClass.Class != NULL)
@@ -35,6 +65,26 @@ void ARealmPlayerController::BeginPlay()
 		if (ca->Tags.Contains("startCam"))
 			SetViewTarget((*camitr));
 	}
+
+	//animation only matters where something is drawing it
+	if (IsLocalController() && GetNetMode() != NM_DedicatedServer)
+	{
+		clientSignificance = NewObject<URealmClientSignificanceManager>(this);
+		clientSignificance->playerOwner = this;
+		clientSignificance->StartUpdatingSignificance();
+	}
+}
+
+void ARealmPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	if (IsValid(clientSignificance))
+	{
+		GetWorldTimerManager().ClearAllTimersForObject(clientSignificance);
+		clientSignificance->ConditionalBeginDestroy();
+		clientSignificance = nullptr;
+	}
 }
 
 void ARealmPlayerController::SetupInputComponent()
@@ -136,22 +186,144 @@ void ARealmPlayerController::ServerMoveCommand_Implementation(FVector_NetQuantiz
 	}
 }
 
-bool ARealmPlayerController::ServerProcessSkillInputData_Validate(const FHitResult& targetData)
+void ARealmPlayerController::ProcessSkillInputData(const FHitResult& targetData)
 {
-	return true;
-}
+	if (!IsValid(playerCharacter) || !IsValid(playerCharacter->GetSkillManager()))
+		return;
 
-void ARealmPlayerController::ServerProcessSkillInputData_Implementation(const FHitResult& targetData)
-{
 	TArray<ASkill*> skills;
 	playerCharacter->GetSkillManager()->GetSkills(skills);
 	for (ASkill* skill : skills)
 	{
-		if (skill->GetSkillState() == ESkillState::Performing)
+		if (IsValid(skill) && skill->GetSkillState() == ESkillState::Performing)
 			skill->TargetInputReceivedWhilePerforming(targetData);
 	}
 }
 
+void ARealmPlayerController::SendDirectedCommand(const FVector& targetLocation, AGameCharacter* target, AActor* pickedActor)
+{
+	//holding the button over the same spot or unit shouldn't keep sending the same command
+	if (bHasSentCommand && target == lastCommandTarget && pickedActor == lastCommandPickedActor && FVector::DistSquared(targetLocation, lastCommandLocation) < FMath::Square(commandResendDistance))
+		return;
+
+	lastCommandLocation = targetLocation;
+	lastCommandTarget = target;
+	lastCommandPickedActor = pickedActor;
+	bHasSentCommand = true;
+
+	sentCommandCount++;
+	ServerDirectedCommand(targetLocation, target, pickedActor, sentCommandCount);
+	PredictDirectedCommand(targetLocation, target, sentCommandCount);
+}
+
+void ARealmPlayerController::PredictDirectedCommand(const FVector& targetLocation, AGameCharacter* target, int32 commandId)
+{
+	//the server's own hero is already moving for real
+	if (Role == ROLE_Authority || !IsValid(playerCharacter))
+		return;
+
+	URealmCharacterMovementComponent* rmc = Cast<URealmCharacterMovementComponent>(playerCharacter->GetCharacterMovement());
+	if (!IsValid(rmc))
+		return;
+
+	//attacks path on the server around a moving target, leave those to the replicated movement
+	if ((IsValid(target) && target->IsAlive() && target->GetTeamIndex() != playerCharacter->GetTeamIndex()) || !playerCharacter->CanMove() || rmc->IsSimulatingDash())
+		rmc->StopPredictedMove();
+	else
+		rmc->StartPredictedMove(targetLocation, commandId);
+}
+
+void ARealmPlayerController::OnRep_RejectedCommand()
+{
+	if (!IsValid(playerCharacter))
+		return;
+
+	URealmCharacterMovementComponent* rmc = Cast<URealmCharacterMovementComponent>(playerCharacter->GetCharacterMovement());
+	if (IsValid(rmc) && rmc->IsPredictingMove() && rejectedCommand >= rmc->GetPredictedCommandId())
+		rmc->StopPredictedMove();
+}
+
+void ARealmPlayerController::ResetDirectedCommandFilter()
+{
+	bHasSentCommand = false;
+	lastCommandTarget = nullptr;
+	lastCommandPickedActor = nullptr;
+}
+
+bool ARealmPlayerController::ServerDirectedCommand_Validate(FVector_NetQuantize targetLocation, AGameCharacter* target, AActor* pickedActor, int32 commandId)
+{
+	return true;
+}
+
+void ARealmPlayerController::ServerDirectedCommand_Implementation(FVector_NetQuantize targetLocation, AGameCharacter* target, AActor* pickedActor, int32 commandId)
+{
+	const float currentTime = GetWorld()->GetTimeSeconds();
+	if (currentTime - commandWindowStart >= 1.f)
+	{
+		commandWindowStart = currentTime;
+		commandsThisWindow = 0;
+	}
+
+	//over the limit, hold onto the newest command so the player still ends up where they last clicked
+	if (commandsThisWindow >= maxCommandsPerSecond)
+	{
+		pendingCommandLocation = targetLocation;
+		pendingCommandTarget = target;
+		pendingCommandPickedActor = pickedActor;
+		pendingCommandId = commandId;
+		bHasPendingCommand = true;
+
+		if (!GetWorldTimerManager().IsTimerActive(pendingCommandTimer))
+			GetWorldTimerManager().SetTimer(pendingCommandTimer, this, &ARealmPlayerController::FlushPendingDirectedCommand, FMath::Max(commandWindowStart + 1.f - currentTime, 0.01f), false);
+
+		return;
+	}
+
+	commandsThisWindow++;
+	bHasPendingCommand = false;
+	ExecuteDirectedCommand(targetLocation, target, pickedActor, commandId);
+}
+
+void ARealmPlayerController::FlushPendingDirectedCommand()
+{
+	if (!bHasPendingCommand)
+		return;
+
+	commandWindowStart = GetWorld()->GetTimeSeconds();
+	commandsThisWindow = 1;
+	bHasPendingCommand = false;
+
+	//either could have been destroyed while the command was held back
+	ExecuteDirectedCommand(pendingCommandLocation, pendingCommandTarget.Get(), pendingCommandPickedActor.Get(), pendingCommandId);
+}
+
+void ARealmPlayerController::ExecuteDirectedCommand(const FVector& targetLocation, AGameCharacter* target, AActor* pickedActor, int32 commandId)
+{
+	if (!IsValid(playerCharacter))
+		return;
+
+	acknowledgedCommand = FMath::Max(acknowledgedCommand, commandId);
+
+	//skills that are aiming only need the point and whatever was under the cursor, allies and our own hero included
+	FHitResult hit;
+	hit.bBlockingHit = true;
+	hit.Location = targetLocation;
+	hit.ImpactPoint = targetLocation;
+	hit.Actor = pickedActor;
+	ProcessSkillInputData(hit);
+
+	if (IsValid(target) && target->IsAlive() && target->GetTeamIndex() != playerCharacter->GetTeamIndex())
+		ServerStartAutoAttack(target);
+	else
+	{
+		//the client started walking as soon as it clicked, tell it if that was wrong
+		if (!playerCharacter->CanMove())
+			rejectedCommand = FMath::Max(rejectedCommand, commandId);
+
+		ServerMoveCommand(targetLocation);
+	}
+}
+
 bool ARealmPlayerController::ServerStartAutoAttack_Validate(AGameCharacter* target)
 {
 	return true;
@@ -201,7 +373,7 @@ void ARealmPlayerController::ServerClearAttackCommands_Implementation()
 		return;
 
 	playerCharacter->SetCurrentTarget(nullptr);
-	GetWorldTimerManager().ClearTimer(aaRangeTimer);
+	pursuitTarget = nullptr;
 	playerCharacter->StopAutoAttack();
 }
 
@@ -259,17 +431,54 @@ void ARealmPlayerController::GetPlayerInAutoAttackRange()
 		return;
 	}
 
-	float distanceSq = (playerCharacter->GetActorLocation() - playerCharacter->GetCurrentTarget()->GetActorLocation()).SizeSquared2D();
-	float aaRange = FMath::Square(playerCharacter->GetStatsManager()->GetCurrentValueForStat(EStat::ES_AARange));
-	if (distanceSq <= aaRange)
+	float aaRange = playerCharacter->GetStatsManager()->GetCurrentValueForStat(EStat::ES_AARange);
+	if (playerCharacter->GetAutoAttackDistanceTo(playerCharacter->GetCurrentTarget()) <= aaRange)
+	{
+		pursuitTarget = nullptr;
 		playerCharacter->StartAutoAttack();
+	}
 	else
 	{
-		moveController->MoveToActor(playerCharacter->GetCurrentTarget());
-		GetWorldTimerManager().SetTimer(aaRangeTimer, this, &ARealmPlayerController::GetPlayerInAutoAttackRange, 0.05f);
+		//the path follows the target as it moves, so the move only needs issuing once
+		pursuitTarget = playerCharacter->GetCurrentTarget();
+		moveController->MoveToActor(pursuitTarget);
+
+		ARealmGameMode* gm = GetWorld()->GetAuthGameMode<ARealmGameMode>();
+		if (IsValid(gm) && IsValid(gm->autoAttackScheduler))
+			gm->autoAttackScheduler->AddPursuer(this);
 	}
 }
 
+bool ARealmPlayerController::UpdateAutoAttackPursuit()
+{
+	if (!IsValid(pursuitTarget) || !IsValid(playerCharacter) || !IsValid(moveController) || playerCharacter->GetCurrentTarget() != pursuitTarget)
+	{
+		pursuitTarget = nullptr;
+		return false;
+	}
+
+	if (!pursuitTarget->IsAlive() || !playerCharacter->CanSeeOtherCharacter(pursuitTarget))
+	{
+		ServerClearAttackCommands();
+		ServerClearMoveCommands();
+		return false;
+	}
+
+	float aaRange = playerCharacter->GetStatsManager()->GetCurrentValueForStat(EStat::ES_AARange);
+	if (playerCharacter->GetAutoAttackDistanceTo(pursuitTarget) <= aaRange)
+	{
+		pursuitTarget = nullptr;
+		playerCharacter->StartAutoAttack();
+		return false;
+	}
+
+	//something else stopped the hero on the way (a stun, a skill), head for the target again once it can move
+	if (moveController->GetMoveStatus() == EPathFollowingStatus::Idle && playerCharacter->CanMove())
+		moveController->MoveToActor(pursuitTarget);
+
+	return true;
+}
+
 TSubclassOf<APlayerCharacter> ARealmPlayerController::GetDefaultCharacterClass() const
 {
 	ARealmPlayerState* ps = Cast<ARealmPlayerState>(PlayerState);
@@ -339,7 +548,7 @@ void ARealmPlayerController::OnTargetSelect()
 {
 	FHitResult hit;
 
-	if (SelectUnitUnderMouse(ECC_Visibility, true, hit))
+	if (SelectUnitUnderMouse(ECC_Visibility, true, hit, false))
 	{
 		AGameCharacter* gc = Cast<AGameCharacter>(hit.GetActor());
 		if (IsValid(gc))
@@ -428,45 +637,54 @@ bool ARealmPlayerController::GetUnitsUnderMouse(ECollisionChannel TraceChannel,
 	return false;
 }
 
-bool ARealmPlayerController::SelectUnitUnderMouse(ECollisionChannel TraceChannel, bool bTraceComplex, FHitResult& chosenHit) const
+bool ARealmPlayerController::SelectUnitUnderMouse(ECollisionChannel TraceChannel, bool bTraceComplex, FHitResult& chosenHit, bool bFallbackToGround) const
 {
 	if (!IsValid(GetPlayerCharacter()))
 		return false;
 
-	TArray<FHitResult> hits;
-	if (GetUnitsUnderMouse(ECC_Camera, true, hits))
+	ULocalPlayer* localPlayer = Cast<ULocalPlayer>(Player);
+	FVector2D mousePosition;
+	if (!localPlayer || !localPlayer->ViewportClient || !localPlayer->ViewportClient->GetMousePosition(mousePosition))
+		return false;
+
+	//select order: 1) enemy units 2) friendly units 3) self, closest to the camera within each
+	APlayerHUD* hud = Cast<APlayerHUD>(GetHUD());
+	if (IsValid(hud))
 	{
-		FHitResult friendlyUnit, otherUnit;
+		const FScreenPickEntry* enemyUnit = nullptr;
+		const FScreenPickEntry* friendlyUnit = nullptr;
+		const FScreenPickEntry* selfUnit = nullptr;
 
-		for (FHitResult testHit : hits)
+		for (const FScreenPickEntry& entry : hud->GetPickableCharacters())
 		{
-			AGameCharacter* gc = Cast<AGameCharacter>(testHit.GetActor());
-			if (!IsValid(gc))
-				continue;
-
-			if (!gc->IsTargetable())
+			AGameCharacter* gc = entry.character.Get();
+			if (!IsValid(gc) || !entry.screenBounds.IsInside(mousePosition))
 				continue;
 
+			const FScreenPickEntry** slot = &selfUnit;
 			if (gc->GetTeamIndex() != GetPlayerCharacter()->GetTeamIndex())
-			{
-				chosenHit = testHit;
-				return true;
-			}
+				slot = &enemyUnit;
 			else if (gc != GetPlayerCharacter())
-				friendlyUnit = testHit;
-			else
-				otherUnit = testHit;
-		}
+				slot = &friendlyUnit;
 
-		//select order: 1) enemy units 2) friendly units 3)self
-		if (IsValid(friendlyUnit.GetComponent()))
-			chosenHit = friendlyUnit;
-		else
-			chosenHit = hits[hits.Num() - 1];
+			if (!(*slot) || entry.cameraDistSq < (*slot)->cameraDistSq)
+				*slot = &entry;
+		}
 
-		return true;
+		const FScreenPickEntry* picked = enemyUnit ? enemyUnit : (friendlyUnit ? friendlyUnit : selfUnit);
+		if (picked)
+		{
+			AGameCharacter* pickedCharacter = picked->character.Get();
+			chosenHit = FHitResult(pickedCharacter, pickedCharacter->GetCapsuleComponent(), pickedCharacter->GetActorLocation(), FVector::UpVector);
+			chosenHit.bBlockingHit = true;
+			return true;
+		}
 	}
 
+	//no unit, only trace the world when the caller needs a point on the ground
+	if (bFallbackToGround)
+		return GetHitResultAtScreenPosition(mousePosition, TraceChannel, bTraceComplex, chosenHit);
+
 	return false;
 }
 
@@ -600,11 +818,26 @@ void ARealmPlayerController::ServerStopBaseTeleport_Implementation()
 	StartBaseTeleport(false);
 }
 
-void ARealmPlayerController::ClientReceiveChat(const FRealmChatEntry& incomingChat)
+void ARealmPlayerController::ClientReceiveChat_Implementation(const FRealmChatEntry& incomingChat)
 {
+	FRealmChatEntry chatEntry = incomingChat;
+
+	//names aren't sent with every message, look the sender up instead
+	ARealmGameState* gs = Cast<ARealmGameState>(GetWorld()->GetGameState());
+	if (IsValid(gs))
+	{
+		ARealmPlayerState* sender = gs->FindPlayerStateById(chatEntry.senderId);
+		if (IsValid(sender))
+			chatEntry.senderName = sender->PlayerName;
+
+		//the server already has it in its history
+		if (Role < ROLE_Authority)
+			gs->AddChatToHistory(chatEntry);
+	}
+
 	APlayerHUD* hud = Cast<APlayerHUD>(GetHUD());
 	if (IsValid(hud))
-		hud->PlayerReceiveChat(incomingChat);
+		hud->PlayerReceiveChat(chatEntry);
 }
 
 void ARealmPlayerController::ClientToggleChat()
@@ -622,8 +855,43 @@ bool ARealmPlayerController::ServerReceiveChat_Validate(const FRealmChatEntry& b
 void ARealmPlayerController::ServerReceiveChat_Implementation(const FRealmChatEntry& broadcastChat)
 {
 	ARealmGameState* gs = Cast<ARealmGameState>(GetWorld()->GetGameState());
-	if (IsValid(gs))
-		gs->BroadcastChat(broadcastChat);
+	ARealmPlayerState* ps = Cast<ARealmPlayerState>(PlayerState);
+	if (!IsValid(gs) || !IsValid(ps) || broadcastChat.chatData.IsEmpty())
+		return;
+
+	const float currentTime = GetWorld()->GetTimeSeconds();
+	if (currentTime - chatWindowStart >= chatInterval)
+	{
+		chatWindowStart = currentTime;
+		chatsThisWindow = 0;
+	}
+
+	//spam gets dropped, chat isn't worth queueing like commands are
+	if (chatsThisWindow >= maxChatsPerInterval)
+		return;
+
+	chatsThisWindow++;
+
+	//only trust the message and the channel from the client, the server fills in the rest
+	FRealmChatEntry chatEntry;
+	chatEntry.chatType = EChatType::CT_PlayerChat;
+	chatEntry.chatData = broadcastChat.chatData.Left(CHAT_MAX_LENGTH);
+	chatEntry.bAllChat = broadcastChat.bAllChat;
+	chatEntry.senderId = ps->PlayerId;
+	chatEntry.senderTeamIndex = ps->GetTeamIndex();
+	chatEntry.timeStamp = currentTime;
+
+	gs->BroadcastChat(chatEntry);
+}
+
+void ARealmPlayerController::ClientReceiveCosmeticEvents_Implementation(const TArray<FRealmCosmeticEvent>& cosmeticEvents)
+{
+	//characters that haven't replicated yet come through as null
+	for (const FRealmCosmeticEvent& cosmeticEvent : cosmeticEvents)
+	{
+		if (IsValid(cosmeticEvent.source))
+			cosmeticEvent.source->PlayCosmeticEvent(cosmeticEvent);
+	}
 }
 
 void ARealmPlayerController::CharacterChosenForGame_Implementation(ARealmPlayerState* choosingPlayer, TSubclassOf<APlayerCharacter> chosenCharacter)
@@ -664,5 +932,7 @@ void ARealmPlayerController::GetLifetimeReplicatedProps(TArray< FLifetimePropert
 
 	DOREPLIFETIME(ARealmPlayerController, playerCharacter);
 	DOREPLIFETIME(ARealmPlayerController, sightList);
+	DOREPLIFETIME_CONDITION(ARealmPlayerController, acknowledgedCommand, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ARealmPlayerController, rejectedCommand, COND_OwnerOnly);
 	//DOREPLIFETIME(ARealmPlayerController, fogOfWar);
 }
\ No newline at end of file
@@ -5,7 +5,16 @@
 ARealmRaiderAI::ARealmRaiderAI(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
+	bUsesSignificance = true;
+}
+
+void ARealmRaiderAI::OnSignificanceChanged(ERealmSignificance oldSignificance)
+{
+	Super::OnSignificanceChanged(oldSignificance);
 
+	const float oldScale = SignificanceReevaluationScale[(uint8)oldSignificance];
+	RescaleRepeatingTimer(rangeTimer, this, &ARealmRaiderAI::ReevaluateTargets, oldScale);
+	RescaleRepeatingTimer(objectiveTimer, this, &ARealmRaiderAI::CheckReachedObjective, oldScale);
 }
 
 void ARealmRaiderAI::Possess(APawn* InPawn)
@@ -18,9 +27,8 @@ void ARealmRaiderAI::Possess(APawn* InPawn)
 
 	mc->GetStatsManager()->SetMaxHealth();
 
-	FTimerHandle t;
-	GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmRaiderAI::ReevaluateTargets, 0.8f, true);
-	GetWorldTimerManager().SetTimer(t, this, &ARealmRaiderAI::CheckReachedObjective, 0.8f, true);
+	GetWorldTimerManager().SetTimer(rangeTimer, this, &ARealmRaiderAI::ReevaluateTargets, 0.8f * GetReevaluationScale(), true);
+	GetWorldTimerManager().SetTimer(objectiveTimer, this, &ARealmRaiderAI::CheckReachedObjective, 0.8f * GetReevaluationScale(), true);
 	GetWorldTimerManager().SetTimer(spawnIntroTimer, 7.f, false);
 
 	spawnLocation = mc->GetActorLocation();
@@ -0,0 +1,169 @@
+#include "Realm.h"
+#include "RealmRangeGrid.h"
+#include "RealmGameMode.h"
+#include "RealmObjective.h"
+
+URealmRangeGrid::URealmRangeGrid(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	gameOwner = nullptr;
+	bWatchersBuilt = false;
+	updateInterval = 0.1f;
+}
+
+void URealmRangeGrid::StartTrackingRanges()
+{
+	if (IsValid(gameOwner))
+		gameOwner->GetWorldTimerManager().SetTimer(rangeTimer, this, &URealmRangeGrid::UpdateRanges, updateInterval, true);
+}
+
+FIntPoint URealmRangeGrid::GetCell(const FVector& location) const
+{
+	return FIntPoint(FMath::FloorToInt(location.X / RANGE_GRID_CELL_SIZE), FMath::FloorToInt(location.Y / RANGE_GRID_CELL_SIZE));
+}
+
+void URealmRangeGrid::BuildWatchers()
+{
+	bWatchersBuilt = true;
+
+	UWorld* gameWorld = IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr;
+	if (!gameWorld)
+		return;
+
+	for (TActorIterator<ARealmObjective> itr(gameWorld); itr; ++itr)
+	{
+		ARealmObjective* structure = *itr;
+		if (!IsValid(structure))
+			continue;
+
+		const float range = structure->GetWatchedRange();
+		if (range <= 0.f)
+			continue;
+
+		FRangeWatcher watcher;
+		watcher.structure = structure;
+		watcher.center = FVector2D(structure->GetActorLocation());
+		watcher.range = range;
+		watcher.rangeSq = FMath::Square(range);
+
+		const int32 watcherIndex = watchers.Add(watcher);
+
+		//mark every cell a unit in range could be standing in, and note the ones the range swallows whole
+		const float paddedRange = range + RANGE_GRID_MAX_UNIT_RADIUS;
+		const float paddedRangeSq = FMath::Square(paddedRange);
+		const FIntPoint minCell = GetCell(FVector(watcher.center.X - paddedRange, watcher.center.Y - paddedRange, 0.f));
+		const FIntPoint maxCell = GetCell(FVector(watcher.center.X + paddedRange, watcher.center.Y + paddedRange, 0.f));
+		for (int32 x = minCell.X; x <= maxCell.X; x++)
+		{
+			for (int32 y = minCell.Y; y <= maxCell.Y; y++)
+			{
+				const FVector2D cellMin(x * RANGE_GRID_CELL_SIZE, y * RANGE_GRID_CELL_SIZE);
+				const FVector2D cellMax = cellMin + FVector2D(RANGE_GRID_CELL_SIZE, RANGE_GRID_CELL_SIZE);
+
+				const FVector2D closest(FMath::Clamp(watcher.center.X, cellMin.X, cellMax.X), FMath::Clamp(watcher.center.Y, cellMin.Y, cellMax.Y));
+				if (FVector2D::DistSquared(closest, watcher.center) > paddedRangeSq)
+					continue;
+
+				const FVector2D farthest(FMath::Abs(cellMin.X - watcher.center.X) > FMath::Abs(cellMax.X - watcher.center.X) ? cellMin.X : cellMax.X,
+					FMath::Abs(cellMin.Y - watcher.center.Y) > FMath::Abs(cellMax.Y - watcher.center.Y) ? cellMin.Y : cellMax.Y);
+
+				cells.FindOrAdd(FIntPoint(x, y)).Add(FRangeCellWatcher(watcherIndex, FVector2D::DistSquared(farthest, watcher.center) <= watcher.rangeSq));
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("range grid: %d structures covering %d cells"), watchers.Num(), cells.Num());
+}
+
+bool URealmRangeGrid::IsInsideWatcher(AGameCharacter* unit, const FRangeWatcher& watcher, bool bFullyCovered) const
+{
+	if (!watcher.structure.IsValid() || !watcher.structure->IsAlive() || !unit->IsAlive() || !watcher.structure->ShouldWatchUnit(unit))
+		return false;
+
+	if (bFullyCovered)
+		return true;
+
+	//to the capsule edge, the same distance the turret's auto attack checks
+	const float reach = watcher.range + FMath::Min(unit->GetCapsuleComponent()->GetScaledCapsuleRadius(), RANGE_GRID_MAX_UNIT_RADIUS);
+	return FVector2D::DistSquared(FVector2D(unit->GetActorLocation()), watcher.center) <= FMath::Square(reach);
+}
+
+void URealmRangeGrid::UpdateRanges()
+{
+	if (!bWatchersBuilt)
+		BuildWatchers();
+
+	if (!IsValid(gameOwner) || watchers.Num() == 0)
+		return;
+
+	//notifications can add and remove sight units (a turret kill), so work from a copy
+	TArray<AGameCharacter*> sightUnits = gameOwner->availableSightUnits;
+	for (AGameCharacter* unit : sightUnits)
+	{
+		if (!IsValid(unit))
+			continue;
+
+		const FIntPoint cell = GetCell(unit->GetActorLocation());
+		const TArray<FRangeCellWatcher>* cellWatchers = cells.Find(cell);
+
+		FRangeWatchedUnit* state = units.Find(unit);
+
+		//the usual case, a unit out in the open that isn't in any range
+		if (!cellWatchers && (!state || state->insideWatchers.Num() == 0))
+			continue;
+
+		if (!state)
+			state = &units.Add(unit);
+
+		//anything not covered by the unit's new cell has been left behind
+		for (int32 i = state->insideWatchers.Num() - 1; i >= 0; i--)
+		{
+			const int32 watcherIndex = state->insideWatchers[i];
+
+			const FRangeCellWatcher* cellWatcher = cellWatchers ? cellWatchers->FindByPredicate([watcherIndex](const FRangeCellWatcher& w) { return w.watcherIndex == watcherIndex; }) : nullptr;
+			if (cellWatcher && IsInsideWatcher(unit, watchers[watcherIndex], cellWatcher->bFullyCovered))
+				continue;
+
+			state->insideWatchers.RemoveAtSwap(i);
+			if (watchers[watcherIndex].structure.IsValid())
+				watchers[watcherIndex].structure->OnUnitLeftRange(unit);
+		}
+
+		if (cellWatchers)
+		{
+			for (const FRangeCellWatcher& cellWatcher : *cellWatchers)
+			{
+				if (!state->insideWatchers.Contains(cellWatcher.watcherIndex) && IsInsideWatcher(unit, watchers[cellWatcher.watcherIndex], cellWatcher.bFullyCovered))
+				{
+					state->insideWatchers.Add(cellWatcher.watcherIndex);
+					watchers[cellWatcher.watcherIndex].structure->OnUnitEnteredRange(unit);
+				}
+			}
+		}
+	}
+
+	//units destroyed without dying first (a disconnect) still count as inside, take them out before forgetting them
+	for (auto itr = units.CreateIterator(); itr; ++itr)
+	{
+		if (itr.Key().IsValid())
+			continue;
+
+		//pending kill units can still be removed by pointer, ones already collected have been nulled out of the structures
+		AGameCharacter* unit = itr.Key().Get(true);
+		if (unit)
+			LeaveAllWatchers(unit, itr.Value());
+
+		itr.RemoveCurrent();
+	}
+}
+
+void URealmRangeGrid::LeaveAllWatchers(AGameCharacter* unit, FRangeWatchedUnit& state)
+{
+	for (int32 watcherIndex : state.insideWatchers)
+	{
+		if (watchers[watcherIndex].structure.IsValid())
+			watchers[watcherIndex].structure->OnUnitLeftRange(unit);
+	}
+
+	state.insideWatchers.Empty();
+}
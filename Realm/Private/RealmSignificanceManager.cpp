@@ -0,0 +1,153 @@
+#include "Realm.h"
+#include "RealmSignificanceManager.h"
+#include "RealmGameMode.h"
+#include "RealmFogofWarManager.h"
+#include "GameCharacter.h"
+#include "PlayerCharacter.h"
+
+URealmSignificanceManager::URealmSignificanceManager(const FObjectInitializer& objectInitializer)
+: Super(objectInitializer)
+{
+	gameOwner = nullptr;
+
+	highDistance = 2500.f;
+	mediumDistance = 5000.f;
+	hysteresisDistance = 300.f;
+	demoteUpdates = 2;
+	updateInterval = 0.5f;
+	reportInterval = 30.f;
+	lastReportTime = 0.f;
+
+	for (int32 i = 0; i < (uint8)ERealmSignificance::RS_MAX; i++)
+		tierCounts[i] = 0;
+}
+
+void URealmSignificanceManager::StartUpdatingSignificance()
+{
+	if (IsValid(gameOwner))
+		gameOwner->GetWorldTimerManager().SetTimer(significanceTimer, this, &URealmSignificanceManager::UpdateSignificance, updateInterval, true);
+}
+
+void URealmSignificanceManager::UpdateSignificance()
+{
+	UWorld* gameWorld = IsValid(gameOwner) ? gameOwner->GetWorld() : nullptr;
+	if (!gameWorld)
+		return;
+
+	TArray<FVector> playerLocations;
+	for (TActorIterator<APlayerCharacter> itr(gameWorld); itr; ++itr)
+	{
+		if (IsValid(*itr) && (*itr)->IsAlive())
+			playerLocations.Add((*itr)->GetActorLocation());
+	}
+
+	for (int32 i = 0; i < (uint8)ERealmSignificance::RS_MAX; i++)
+		tierCounts[i] = 0;
+
+	for (TActorIterator<ARealmMoveController> itr(gameWorld); itr; ++itr)
+	{
+		ARealmMoveController* controller = *itr;
+		if (!IsValid(controller) || !controller->UsesSignificance())
+			continue;
+
+		AGameCharacter* unit = Cast<AGameCharacter>(controller->GetPawn());
+		if (!IsValid(unit))
+			continue;
+
+		FSignificanceState& state = controllerStates.FindOrAdd(controller);
+		const ERealmSignificance current = controller->GetSignificance();
+
+		//promote as soon as a unit qualifies, a player should never see a sluggish minion
+		ERealmSignificance target = CalculateSignificance(unit, playerLocations, 0.f);
+		if (target < current)
+		{
+			controller->SetSignificance(target);
+			state.pendingUpdates = 0;
+		}
+		else if (target > current)
+		{
+			//only demote once the unit is clear of the range by the margin, and has stayed that way
+			target = CalculateSignificance(unit, playerLocations, hysteresisDistance);
+			if (target > current)
+			{
+				if (state.pendingSignificance == target)
+					state.pendingUpdates++;
+				else
+				{
+					state.pendingSignificance = target;
+					state.pendingUpdates = 1;
+				}
+
+				if (state.pendingUpdates >= demoteUpdates)
+				{
+					controller->SetSignificance(target);
+					state.pendingUpdates = 0;
+				}
+			}
+			else
+				state.pendingUpdates = 0;
+		}
+		else
+			state.pendingUpdates = 0;
+
+		tierCounts[(uint8)controller->GetSignificance()]++;
+	}
+
+	//forget controllers that have been destroyed
+	for (auto itr = controllerStates.CreateIterator(); itr; ++itr)
+	{
+		if (!itr.Key().IsValid())
+			itr.RemoveCurrent();
+	}
+
+	const float currentTime = gameWorld->GetTimeSeconds();
+	if (reportInterval > 0.f && currentTime - lastReportTime >= reportInterval)
+	{
+		lastReportTime = currentTime;
+		UE_LOG(LogTemp, Log, TEXT("significance: %d high, %d medium, %d low"), tierCounts[(uint8)ERealmSignificance::RS_High],
+			tierCounts[(uint8)ERealmSignificance::RS_Medium], tierCounts[(uint8)ERealmSignificance::RS_Low]);
+	}
+}
+
+ERealmSignificance URealmSignificanceManager::CalculateSignificance(AGameCharacter* unit, const TArray<FVector>& playerLocations, float margin) const
+{
+	const FVector unitLocation = unit->GetActorLocation();
+	const float highDistanceSq = FMath::Square(highDistance + margin);
+	const float mediumDistanceSq = FMath::Square(mediumDistance + margin);
+
+	float closestDistanceSq = MAX_flt;
+	for (const FVector& location : playerLocations)
+		closestDistanceSq = FMath::Min(closestDistanceSq, FVector::DistSquared(unitLocation, location));
+
+	if (closestDistanceSq <= highDistanceSq)
+		return ERealmSignificance::RS_High;
+
+	if (closestDistanceSq <= mediumDistanceSq || IsVisibleToEnemyTeam(unit))
+		return ERealmSignificance::RS_Medium;
+
+	return ERealmSignificance::RS_Low;
+}
+
+bool URealmSignificanceManager::IsVisibleToEnemyTeam(AGameCharacter* unit) const
+{
+	if (!IsValid(gameOwner) || !IsValid(gameOwner->fogOfWar))
+		return false;
+
+	//the last list is the npc sight list, only player teams matter here
+	const TArray<FTeamSightList>& sightLists = gameOwner->fogOfWar->enemySightLists;
+	for (int32 i = 0; i < sightLists.Num() - 1; i++)
+	{
+		if (i != unit->GetTeamIndex() && sightLists[i].sightList.Contains(unit))
+			return true;
+	}
+
+	return false;
+}
+
+int32 URealmSignificanceManager::GetTierCount(ERealmSignificance tier) const
+{
+	if ((uint8)tier >= (uint8)ERealmSignificance::RS_MAX)
+		return 0;
+
+	return tierCounts[(uint8)tier];
+}
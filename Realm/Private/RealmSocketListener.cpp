@@ -1,23 +1,206 @@
 #include "Realm.h"
 #include "RealmSocketListener.h"
 #include "RealmGameInstance.h"
+#include "Async.h"
 
-FRealmSocketListener::FRealmSocketListener(FSocket* socketToListenTo, bool LoginSocket)
+TMap<FString, FRealmHostResolver::FCachedHost> FRealmHostResolver::cachedHosts;
+FCriticalSection FRealmHostResolver::cacheLock;
+const double FRealmHostResolver::CacheTTL = 300.0;
+
+const float FRealmSocketListener::MinReconnectDelay = 0.5f;
+const float FRealmSocketListener::MaxReconnectDelay = 30.f;
+
+bool FRealmHostResolver::GetCachedAddress(const FString& host, uint32& outIp)
+{
+	FScopeLock lock(&cacheLock);
+
+	const FCachedHost* cached = cachedHosts.Find(host);
+	if (!cached || FPlatformTime::Seconds() - cached->resolveTime > CacheTTL)
+		return false;
+
+	outIp = cached->ip;
+	return true;
+}
+
+bool FRealmHostResolver::ResolveBlocking(const FString& host, uint32& outIp)
+{
+	if (GetCachedAddress(host, outIp))
+		return true;
+
+	FResolveInfo* resolveInfo = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetHostByName(TCHAR_TO_ANSI(*host));
+	if (!resolveInfo)
+		return false;
+
+	while (!resolveInfo->IsComplete())
+		FPlatformProcess::Sleep(0.01f);
+
+	bool bResolved = resolveInfo->GetErrorCode() == 0;
+	if (bResolved)
+	{
+		resolveInfo->GetResolvedAddress().GetIp(outIp);
+
+		FScopeLock lock(&cacheLock);
+		FCachedHost& cached = cachedHosts.FindOrAdd(host);
+		cached.ip = outIp;
+		cached.resolveTime = FPlatformTime::Seconds();
+	}
+	else
+		UE_LOG(LogTemp, Warning, TEXT("failed to resolve the hostname %s"), *host);
+
+	delete resolveInfo;
+	return bResolved;
+}
+
+void FRealmHostResolver::Prefetch(const FString& host)
 {
-	listenSocket = socketToListenTo;
+	uint32 ip = 0;
+	if (GetCachedAddress(host, ip))
+		return;
+
+	Async<void>(EAsyncExecution::ThreadPool, [host]()
+	{
+		uint32 resolvedIp = 0;
+		FRealmHostResolver::ResolveBlocking(host, resolvedIp);
+	});
+}
+
+void FRealmHostResolver::Invalidate(const FString& host)
+{
+	FScopeLock lock(&cacheLock);
+	cachedHosts.Remove(host);
+}
+
+FRealmSocketListener::FRealmSocketListener(const FString& inHost, int32 inPort, bool LoginSocket)
+{
+	listenSocket = nullptr;
+	gameInstance = nullptr;
+	host = inHost;
+	port = inPort;
 	bLoginSocket = LoginSocket;
-	listenerThread = FRunnableThread::Create(this, TEXT("FRealmSocketListener"));
+	reconnectDelay = MinReconnectDelay;
+	nextConnectTime = 0.0;
+	listenerThread = FRunnableThread::Create(this, bLoginSocket ? TEXT("FRealmSocketListener_Login") : TEXT("FRealmSocketListener_Multiplayer"), 0, TPri_BelowNormal);
 }
 
 FRealmSocketListener::~FRealmSocketListener()
 {
 	delete listenerThread;
 	listenerThread = nullptr;
+
+	Disconnect();
+}
+
+bool FRealmSocketListener::Connect()
+{
+	if (FPlatformTime::Seconds() < nextConnectTime)
+		return false;
+
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+
+	uint32 ip = 0;
+	bool bConnected = false;
+	if (FRealmHostResolver::ResolveBlocking(host, ip))
+	{
+		TSharedRef<FInternetAddr> addr = socketSubsystem->CreateInternetAddr();
+		addr->SetIp(ip);
+		addr->SetPort(port);
+
+		listenSocket = socketSubsystem->CreateSocket(NAME_Stream, bLoginSocket ? TEXT("login") : TEXT("multiplayer"), false);
+		if (listenSocket)
+		{
+			int32 ReceiveBufferSize = 2 * 1024 * 1024;
+			int32 newSize = 0;
+			listenSocket->SetReceiveBufferSize(ReceiveBufferSize, newSize);
+			listenSocket->SetSendBufferSize(ReceiveBufferSize, newSize);
+
+			bConnected = listenSocket->Connect(*addr);
+		}
+
+		//the address might be stale, look it up again next time
+		if (!bConnected)
+			FRealmHostResolver::Invalidate(host);
+	}
+
+	if (!bConnected)
+	{
+		Disconnect();
+
+		UE_LOG(LogTemp, Warning, TEXT("failed to connect to %s:%d, retrying in %.1f seconds"), *host, port, reconnectDelay);
+		nextConnectTime = FPlatformTime::Seconds() + reconnectDelay;
+		reconnectDelay = FMath::Min(reconnectDelay * 2.f, MaxReconnectDelay);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("connected to %s:%d"), *host, port);
+
+	reconnectDelay = MinReconnectDelay;
+	connected.Set(1);
+	return true;
+}
+
+void FRealmSocketListener::Disconnect()
+{
+	connected.Set(0);
+
+	//a partial frame from the old connection would corrupt the new one
+	codec.Reset();
+
+	if (listenSocket)
+	{
+		listenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(listenSocket);
+		listenSocket = nullptr;
+	}
+}
+
+void FRealmSocketListener::FlushOutgoing()
+{
+	TArray<uint8>* pending = outgoingQueue.Peek();
+	while (pending && listenSocket)
+	{
+		int32 sent = 0;
+		if (!listenSocket->Send(pending->GetData(), pending->Num(), sent) || sent != pending->Num())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("failed to send to %s:%d, reconnecting"), *host, port);
+			Disconnect();
+			return;
+		}
+
+		TArray<uint8> sentData;
+		outgoingQueue.Dequeue(sentData);
+		pending = outgoingQueue.Peek();
+	}
 }
 
 void FRealmSocketListener::ListenForData()
 {
+	TArray<uint8> ReceivedData;
+
+	uint32 Size;
+	while (listenSocket && listenSocket->HasPendingData(Size))
+	{
+		ReceivedData.SetNumUninitialized(FMath::Min(Size, 65507u));
 
+		int32 Read = 0;
+		if (!listenSocket->Recv(ReceivedData.GetData(), ReceivedData.Num(), Read))
+		{
+			Disconnect();
+			return;
+		}
+
+		codec.AppendData(ReceivedData.GetData(), Read);
+	}
+
+	//reads can end mid frame or hold several, only whole messages go to the game thread
+	FLobbyMessage message;
+	while (codec.NextMessage(message))
+		dataQueue.Enqueue(message);
+
+	if (codec.IsCorrupt())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("received a malformed message from %s:%d, reconnecting"), *host, port);
+		Disconnect();
+	}
 }
 
 bool FRealmSocketListener::Init()
@@ -29,33 +212,22 @@ uint32 FRealmSocketListener::Run()
 {
 	while (stopListenerThread.GetValue() == 0)
 	{
-		if (!listenSocket)
-			continue;
-
-		TArray<uint8> ReceivedData;
-
-		uint32 Size;
-		while (listenSocket->HasPendingData(Size))
+		if (!listenSocket || listenSocket->GetConnectionState() != SCS_Connected)
 		{
-			ReceivedData.SetNumUninitialized(FMath::Min(Size, 65507u));
-
-			int32 Read = 0;
-			listenSocket->Recv(ReceivedData.GetData(), ReceivedData.Num(), Read);
+			Disconnect();
+			Connect();
 		}
-		//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
-		if (ReceivedData.Num() <= 0)
+		if (listenSocket)
 		{
-			//No Data Received
-			continue;
+			FlushOutgoing();
+			ListenForData();
 		}
 
-		dataQueue.Enqueue(ReceivedData);
-
-		//Initial wait before starting
 		FPlatformProcess::Sleep(0.03);
 	}
 
+	Disconnect();
 	return 0;
 }
 
@@ -67,23 +239,27 @@ void FRealmSocketListener::Stop()
 void FRealmSocketListener::EnsureCompletion()
 {
 	Stop();
-	listenerThread->WaitForCompletion();
+
+	if (listenerThread)
+		listenerThread->WaitForCompletion();
+}
+
+void FRealmSocketListener::Send(const FLobbyMessage& message)
+{
+	TArray<uint8> data;
+	FLobbyCodec::Encode(message, data);
+	outgoingQueue.Enqueue(data);
 }
 
-FRealmSocketListener* FRealmSocketListener::CreateListener(FSocket* socketToListenTo, bool LoginSocket)
+FRealmSocketListener* FRealmSocketListener::CreateListener(const FString& inHost, int32 inPort, bool LoginSocket)
 {
 	if (FPlatformProcess::SupportsMultithreading())
-		return new FRealmSocketListener(socketToListenTo, LoginSocket);
+		return new FRealmSocketListener(inHost, inPort, LoginSocket);
 	else
 		return nullptr;
 }
 
-void FRealmSocketListener::GetNextDataArray(TArray<uint8>& outArray)
+bool FRealmSocketListener::GetNextMessage(FLobbyMessage& outMessage)
 {
-	TArray<uint8> data;
-
-	if (!dataQueue.IsEmpty())
-		dataQueue.Dequeue(data);
-
-	outArray = data;
-}
\ No newline at end of file
+	return dataQueue.Dequeue(outMessage);
+}
@@ -40,21 +40,13 @@ void ATurret::CheckAutoAttack()
 		return;
 	}
 
-	float distance = (GetActorLocation() - currentTarget->GetActorLocation()).Size2D();
-	if (distance > statsManager->GetCurrentValueForStat(EStat::ES_AARange))
+	if (GetAutoAttackDistanceTo(currentTarget) > statsManager->GetCurrentValueForStat(EStat::ES_AARange))
 	{
 		StopAutoAttack();
 		TargetOutofRange();
 	}
 	else if (!bAutoAttackLaunching && !bAutoAttackOnCooldown)
-	{
-		float scale = statsManager->GetCurrentValueForStat(EStat::ES_AtkSp) / statsManager->GetBaseValueForStat(EStat::ES_AtkSp);
-		//AllPlayAnimMontage(autoAttackManager->GetCurrentAttackAnimation(), scale);
-
-		GetWorldTimerManager().SetTimer(aaLaunchTimer, this, &AGameCharacter::LaunchAutoAttack, autoAttackManager->GetAutoAttackLaunchTime() / scale);
-
-		bAutoAttackLaunching = true;
-	}
+		BeginAutoAttackLaunch();
 }
 
 void ATurret::OnFinishAATimer()
@@ -73,37 +65,17 @@ void ATurret::TargetOutofRange()
 	if (!IsValid(this))
 		return;
 
-	TArray<FHitResult> hits;
-	FVector start = GetActorLocation();
-	FVector end = start;
-	end.Z += 5.f;
-
-	TArray<AGameCharacter*> possibleTargets;
-
-	GetWorld()->SweepMultiByChannel(hits, start, end, GetActorRotation().Quaternion(), ECC_Visibility, FCollisionShape::MakeSphere(GetCurrentValueForStat(EStat::ES_AARange)));
-	for (FHitResult hit : hits)
+	//the range grid keeps the list sorted, minions first, then objectives, then mythos
+	for (int32 i = 0; i < inRangeTargets.Num(); i++)
 	{
-		AGameCharacter* gc = Cast<AGameCharacter>(hit.GetActor());
-		if (IsValid(gc) && gc->IsAlive() && GetTeamIndex() != gc->GetTeamIndex())
-			possibleTargets.AddUnique(gc);
-	}
-
-	//first aggro any minions first
-	for (AGameCharacter* gc : possibleTargets)
-	{
-		if (gc->IsA(AMinionCharacter::StaticClass()))
+		AGameCharacter* gc = inRangeTargets[i];
+		if (!IsValid(gc))
 		{
-			SetCurrentTarget(gc);
-			StartAutoAttack();
-
-			return;
+			inRangeTargets.RemoveAt(i--);
+			continue;
 		}
-	}
 
-	//then aggro an objective if we can 
-	for (AGameCharacter* gc : possibleTargets)
-	{
-		if (gc->IsA(ARealmObjective::StaticClass()))
+		if (gc->IsAlive() && gc->IsTargetable())
 		{
 			SetCurrentTarget(gc);
 			StartAutoAttack();
@@ -112,19 +84,49 @@ void ATurret::TargetOutofRange()
 		}
 	}
 
-	//lastly aggro any mythos
-	for (AGameCharacter* gc : possibleTargets)
-	{
-		if (gc->IsA(APlayerCharacter::StaticClass()))
-		{
-			SetCurrentTarget(gc);
-			StartAutoAttack();
+	StopAutoAttack();
+}
 
-			return;
-		}
-	}
+int32 ATurret::GetTargetPriority(AGameCharacter* unit) const
+{
+	if (unit->IsA(AMinionCharacter::StaticClass()))
+		return 0;
+	if (unit->IsA(ARealmObjective::StaticClass()))
+		return 1;
+	if (unit->IsA(APlayerCharacter::StaticClass()))
+		return 2;
+
+	return INDEX_NONE;
+}
 
-	StopAutoAttack();
+float ATurret::GetWatchedRange() const
+{
+	return GetCurrentValueForStat(EStat::ES_AARange);
+}
+
+bool ATurret::ShouldWatchUnit(AGameCharacter* unit) const
+{
+	return unit->GetTeamIndex() != GetTeamIndex() && GetTargetPriority(unit) != INDEX_NONE;
+}
+
+void ATurret::OnUnitEnteredRange(AGameCharacter* unit)
+{
+	//insert after everything of the same or higher priority so the list stays in targeting order
+	const int32 priority = GetTargetPriority(unit);
+
+	int32 index = 0;
+	while (index < inRangeTargets.Num() && (!IsValid(inRangeTargets[index]) || GetTargetPriority(inRangeTargets[index]) <= priority))
+		index++;
+
+	inRangeTargets.Insert(unit, index);
+
+	if (!IsValid(currentTarget) && IsAlive())
+		TargetOutofRange();
+}
+
+void ATurret::OnUnitLeftRange(AGameCharacter* unit)
+{
+	inRangeTargets.Remove(unit);
 }
 
 /*void ATurret::PostRenderFor(class APlayerController* PC, class UCanvas* Canvas, FVector CameraPosition, FVector CameraDir)
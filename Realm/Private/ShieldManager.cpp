@@ -3,102 +3,185 @@
 #include "GameCharacter.h"
 #include "UnrealNetwork.h"
 
-AShieldManager::AShieldManager(const FObjectInitializer& objectInitializer)
+UShieldManager::UShieldManager(const FObjectInitializer& objectInitializer)
 : Super(objectInitializer)
 {
-	bReplicates = true;
-	bAlwaysRelevant = true;
-
-	NetUpdateFrequency = 15.f;
+	owningCharacter = nullptr;
+	scheduledExpiry = 0.f;
 }
 
-void AShieldManager::UpdateTotalShieldAmount()
+uint8 UShieldManager::GetDamageTypeMask(TSubclassOf<UDamageType> damageType)
 {
-	float localTotalShield = 0.f;
+	if (!damageType)
+		return 0;
 
-	for (auto& shield : shields)
-		localTotalShield += shield.Value.amount;
+	if (damageType->IsChildOf(UPhysicalDamage::StaticClass()))
+		return SHIELD_DAMAGE_PHYSICAL;
+	if (damageType->IsChildOf(USpecialDamage::StaticClass()))
+		return SHIELD_DAMAGE_SPECIAL;
+	if (damageType->IsChildOf(UTrueDamage::StaticClass()))
+		return SHIELD_DAMAGE_TRUE;
 
-	totalShieldAmount = localTotalShield;
+	return SHIELD_DAMAGE_OTHER;
 }
 
-void AShieldManager::AddShield(FCharacterShield newShield)
+void UShieldManager::AddShield(FCharacterShield newShield)
 {
-	if (!IsValid(owningCharacter))
+	if (!IsValid(owningCharacter) || newShield.amountMax <= 0.f)
 		return;
 
-	if (newShield.amountMax > 0)
+	//same key replaces the old shield
+	for (int32 i = 0; i < shields.Num(); i++)
 	{
-		newShield.amount = newShield.amountMax;
-		shields.Add(newShield.key, newShield);
+		if (shields[i].key == newShield.key)
+		{
+			RemoveShieldAt(i);
+			break;
+		}
+	}
 
-		if (newShield.duration > 0.f)
-			owningCharacter->GetWorld()->GetTimerManager().SetTimer(newShield.timer, FTimerDelegate::CreateUObject(this, &AShieldManager::ShieldFinished, newShield), newShield.duration, false);
+	newShield.amount = newShield.amountMax;
+	newShield.expireTime = newShield.duration > 0.f ? owningCharacter->GetWorld()->GetTimeSeconds() + newShield.duration : 0.f;
 
-		UpdateTotalShieldAmount();
-	}
+	newShield.damageTypeMask = 0;
+	for (TSubclassOf<UDamageType> damageType : newShield.damageTypes)
+		newShield.damageTypeMask |= GetDamageTypeMask(damageType);
+
+	int32 insertIndex = 0;
+	while (insertIndex < shields.Num() && shields[insertIndex].AbsorbsBefore(newShield))
+		insertIndex++;
+
+	shields.Insert(newShield, insertIndex);
+	totalShieldAmount += newShield.amount;
+
+	ScheduleNextExpiry();
 }
 
-bool AShieldManager::CanAbsorbDamage() const
+bool UShieldManager::CanAbsorbDamage() const
 {
 	return GetTotalShieldAmount() > 0;
 }
 
-float AShieldManager::TryAbsorbDamage(float dmgAmount, TSubclassOf<UDamageType> dmgType)
+float UShieldManager::TryAbsorbDamage(float dmgAmount, TSubclassOf<UDamageType> dmgType)
 {
-	for (auto& shield : shields)
+	if (shields.Num() == 0 || dmgAmount <= 0.f)
+		return dmgAmount;
+
+	RemoveExpiredShields();
+
+	const uint8 damageMask = GetDamageTypeMask(dmgType);
+	bool bDepletedShield = false;
+
+	for (FCharacterShield& shield : shields)
 	{
-		if (shield.Value.damageTypes.Contains(dmgType)) //found a shield that can absorb this type of damage
+		if (!(shield.damageTypeMask & damageMask))
+			continue;
+
+		const float absorbed = FMath::Min(shield.amount, dmgAmount);
+		shield.amount -= absorbed;
+		totalShieldAmount -= absorbed;
+		dmgAmount -= absorbed;
+
+		bDepletedShield |= shield.amount <= 0.f;
+		if (dmgAmount <= 0.f)
+			break;
+	}
+
+	//broken shields are only removed once the loop is done with the array
+	if (bDepletedShield)
+	{
+		shields.RemoveAll([](const FCharacterShield& shield) { return shield.amount <= 0.f; });
+		ScheduleNextExpiry();
+	}
+
+	totalShieldAmount = FMath::Max(totalShieldAmount, 0.f);
+	return FMath::Max(dmgAmount, 0.f);
+}
+
+float UShieldManager::GetTotalShieldAmount() const
+{
+	return totalShieldAmount;
+}
+
+void UShieldManager::ShieldFinished(FCharacterShield finishingShield)
+{
+	for (int32 i = 0; i < shields.Num(); i++)
+	{
+		if (shields[i].key == finishingShield.key)
 		{
-			if (shield.Value.amount >= dmgAmount)
-			{
-				shield.Value.amount -= dmgAmount;
-				dmgAmount = 0.f;
-				break;
-			}
-			else
-			{
-				dmgAmount -= shield.Value.amount;
-				shield.Value.amount = 0.f;
-				ShieldFinished(shield.Value);
-			}
+			RemoveShieldAt(i);
+			ScheduleNextExpiry();
+			return;
 		}
 	}
+}
 
-	UpdateTotalShieldAmount();
-	return dmgAmount;
+void UShieldManager::RemoveShieldAt(int32 index)
+{
+	totalShieldAmount = FMath::Max(totalShieldAmount - shields[index].amount, 0.f);
+	shields.RemoveAt(index);
 }
 
-float AShieldManager::GetTotalShieldAmount() const
+void UShieldManager::OnExpiryTimer()
 {
-	return totalShieldAmount;
+	scheduledExpiry = 0.f;
+	RemoveExpiredShields();
+}
+
+void UShieldManager::RemoveExpiredShields()
+{
+	if (!IsValid(owningCharacter))
+		return;
+
+	const float currentTime = owningCharacter->GetWorld()->GetTimeSeconds();
+	for (int32 i = shields.Num() - 1; i >= 0; i--)
+	{
+		if (shields[i].expireTime > 0.f && shields[i].expireTime <= currentTime)
+			RemoveShieldAt(i);
+	}
+
+	ScheduleNextExpiry();
 }
 
-void AShieldManager::ShieldFinished(FCharacterShield finishingShield)
+void UShieldManager::ScheduleNextExpiry()
 {
 	if (!IsValid(owningCharacter))
 		return;
 
-	owningCharacter->GetWorld()->GetTimerManager().ClearTimer(finishingShield.timer);
-	shields.Remove(finishingShield.key);
+	float nextExpiry = 0.f;
+	for (const FCharacterShield& shield : shields)
+	{
+		if (shield.expireTime > 0.f && (nextExpiry <= 0.f || shield.expireTime < nextExpiry))
+			nextExpiry = shield.expireTime;
+	}
+
+	//most damage doesn't change which shield runs out first
+	if (nextExpiry == scheduledExpiry)
+		return;
 
-	UpdateTotalShieldAmount();
+	scheduledExpiry = nextExpiry;
+
+	FTimerManager& timerManager = owningCharacter->GetWorld()->GetTimerManager();
+	if (nextExpiry <= 0.f)
+		timerManager.ClearTimer(expiryTimer);
+	else
+		timerManager.SetTimer(expiryTimer, this, &UShieldManager::OnExpiryTimer, FMath::Max(nextExpiry - owningCharacter->GetWorld()->GetTimeSeconds(), 0.01f), false);
 }
 
-bool AShieldManager::DoesContainCharactersShield(AGameCharacter* originatingUnit)
+bool UShieldManager::DoesContainCharactersShield(AGameCharacter* originatingUnit)
 {
-	for (auto& shield : shields)
+	for (const FCharacterShield& shield : shields)
 	{
-		if (shield.Value.originatingCharacter == originatingUnit)
+		if (shield.originatingCharacter == originatingUnit)
 			return true;
 	}
 
 	return false;
 }
 
-void AShieldManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+void UShieldManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AShieldManager, totalShieldAmount);
-}
\ No newline at end of file
+	DOREPLIFETIME(UShieldManager, totalShieldAmount);
+}
@@ -3,6 +3,8 @@
 #include "GameCharacter.h"
 #include "UnrealNetwork.h"
 #include "Projectile.h"
+#include "RealmGroundHeightfield.h"
+#include "RealmLagCompensation.h"
 
 ASkill::ASkill(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
@@ -12,10 +14,14 @@ ASkill::ASkill(const FObjectInitializer& objectInitializer)
 	bAutoCooldownOnInterrupt = false;
 
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	PrimaryActorTick.TickGroup = TG_PrePhysics;
 	SetRemoteRoleForBackwardsCompat(ROLE_SimulatedProxy);
 	bReplicates = true;
-	bAlwaysRelevant = true;
+
+	//follow the character's relevancy. characters are always relevant for now, so this only matters once they aren't
+	bNetUseOwnerRelevancy = true;
+	NetUpdateFrequency = 10.f;
 }
 
 float ASkill::SkillLevelScale(float min, float max, bool bIncreasing) const
@@ -49,13 +55,38 @@ bool ASkill::SphereTrace(AActor* actorToIgnore, const FVector& start, const FVec
 
 	traceParams.AddIgnoredActor(actorToIgnore);
 
-	TObjectIterator<APlayerController> pc;
-	if (!pc)
+	//trace in the caller's world, not whichever player controller happens to come first in the process
+	UWorld* world = IsValid(actorToIgnore) ? actorToIgnore->GetWorld() : nullptr;
+	if (!world)
 		return false;
 
-	DrawDebugSphere(pc->GetWorld(), start, radius, 8, FColor::Red, true);
+	DrawDebugSphere(world, start, radius, 8, FColor::Red, true);
+
+	//on the server, a player's shot is checked against where the characters were on their screen
+	URealmLagCompensation* lagCompensation = traceChannel == ECC_Pawn ? URealmLagCompensation::Get(world) : nullptr;
+	const float rewindTime = lagCompensation ? lagCompensation->GetRewindTime(actorToIgnore) : 0.f;
+	if (rewindTime <= 0.f)
+		return world->SweepMultiByChannel(hitOut, start, end, FQuat(), traceChannel, FCollisionShape::MakeSphere(radius), traceParams);
+
+	world->SweepMultiByChannel(hitOut, start, end, FQuat(), traceChannel, FCollisionShape::MakeSphere(radius), traceParams);
+
+	//characters come from the rewound history instead, everything else is where it is now
+	for (int32 i = hitOut.Num() - 1; i >= 0; i--)
+	{
+		if (Cast<AGameCharacter>(hitOut[i].GetActor()))
+			hitOut.RemoveAt(i, 1, false);
+	}
+
+	if (lagCompensation->SweepCharacters(actorToIgnore, start, end, radius, rewindTime, hitOut))
+	{
+		hitOut.Sort([](const FHitResult& a, const FHitResult& b)
+		{
+			return a.Time < b.Time;
+		});
+	}
 
-	return pc->GetWorld()->SweepMultiByChannel(hitOut, start, end, FQuat(), traceChannel, FCollisionShape::MakeSphere(radius), traceParams);
+	//the physics sweep may only have hit characters that weren't there on the shooter's screen
+	return hitOut.Num() > 0;
 }
 
 bool ASkill::ConeTrace(AActor* actorToIgnore, const FVector& start, const FVector& dir, float coneHeight, TArray<AGameCharacter*>& hitsOut, ECollisionChannel traceChannel /* = ECC_Pawn */)
@@ -98,7 +129,7 @@ void ASkill::InitializeSkill(AGameCharacter* owner)
 	AttachRootComponentToActor(owner);
 
 	characterOwner = owner;
-	skillState = ESkillState::NotLearned;
+	SetSkillState(ESkillState::NotLearned);
 }
 
 void ASkill::AddSkillPoint()
@@ -107,7 +138,7 @@ void ASkill::AddSkillPoint()
 		return;
 
 	if (skillState == ESkillState::NotLearned)
-		skillState = ESkillState::Ready;
+		SetSkillState(ESkillState::Ready);
 
 	if (skillPoints + 1 <= skillPointsMax && CanSkillUpgrade())
 		skillPoints++;
@@ -155,26 +186,23 @@ bool ASkill::CanSkillUpgrade() const
 
 float ASkill::GetCooldownProgressPercent()
 {
-	if (skillState != ESkillState::OnCooldown)
+	if (skillState != ESkillState::OnCooldown || !IsValid(characterOwner))
 		return 0.f;
 
-	float timeElapsed = GetWorldTimerManager().GetTimerElapsed(cooldownTimer);
-	float totalTime = timeElapsed + GetWorldTimerManager().GetTimerRemaining(cooldownTimer);
-
-	return timeElapsed / totalTime;
+	return characterOwner->GetCooldownProgressPercent(this);
 }
 
 float ASkill::GetCooldownRemaining()
 {
-	return GetWorldTimerManager().GetTimerRemaining(cooldownTimer);
+	return IsValid(characterOwner) ? characterOwner->GetCooldownRemaining(this) : 0.f;
 }
 
 void ASkill::StartCooldown(float manualCooldown, ESkillState cdfState)
 {
-	skillState = ESkillState::OnCooldown;
+	SetSkillState(ESkillState::OnCooldown);
 	afterCooldownState = cdfState;
 
-	cooldownTime = SkillLevelScale(cooldownMin, cooldownMax, false);
+	float cooldownTime = SkillLevelScale(cooldownMin, cooldownMax, false);
 	if (manualCooldown > 0.f)
 		cooldownTime = manualCooldown;
 	else if (manualCooldown == 0.f)
@@ -185,18 +213,17 @@ void ASkill::StartCooldown(float manualCooldown, ESkillState cdfState)
 	else
 		cooldownTime -= cooldownTime * FMath::Min(50.f, characterOwner->GetCurrentValueForStat(EStat::ES_CDR)) / 100.f;
 
-	GetWorldTimerManager().SetTimer(cooldownTimer, this, &ASkill::CooldownFinished, cooldownTime);
+	//clients pick up the new state and the cooldown table entry through replication
+	if (Role == ROLE_Authority)
+	{
+		characterOwner->StartCooldown(this, cooldownTime);
+		GetWorldTimerManager().SetTimer(cooldownTimer, this, &ASkill::CooldownFinished, cooldownTime);
+	}
 }
 
 void ASkill::CooldownFinished()
 {
-	skillState = afterCooldownState;
-	cooldownTime = 0.f;
-}
-
-void ASkill::OnCooldownTimerSet()
-{
-	GetWorldTimerManager().SetTimer(cooldownTimer, this, &ASkill::CooldownFinished, cooldownTime);
+	SetSkillState(afterCooldownState);
 }
 
 void ASkill::SkillFinished(float manualCooldown)
@@ -217,6 +244,19 @@ ESkillState ASkill::GetSkillState() const
 void ASkill::SetSkillState(ESkillState newState)
 {
 	skillState = newState;
+	UpdateTickForState();
+}
+
+void ASkill::UpdateTickForState()
+{
+	const bool bPerforming = skillState == ESkillState::Performing;
+	if (IsActorTickEnabled() != bPerforming)
+		SetActorTickEnabled(bPerforming);
+}
+
+void ASkill::OnRep_SkillState()
+{
+	UpdateTickForState();
 }
 
 void ASkill::ServerSkillPerformed_Implementation(FVector mouseHitLoc, AGameCharacter* targetUnit /* = NULL */)
@@ -247,26 +287,7 @@ void ASkill::ReenableSkill()
 
 FVector ASkill::GetGroundLocationBeneathPoint(FVector point)
 {
-	FHitResult hit;
-	FVector start = point;
-
-	FVector end = start;
-	end.Z -= 100000.f;
-
-	//get all game characters and projectiles currently in the world so we can ignore them later
-	TArray<AActor*> ignoredActors;
-	for (TActorIterator<AGameCharacter> chr(GetWorld()); chr; ++chr)
-		ignoredActors.AddUnique(*chr);
-	for (TActorIterator<AProjectile> pro(GetWorld()); pro; ++pro)
-		ignoredActors.AddUnique(*pro);
-
-	FCollisionQueryParams collisionParams;
-	collisionParams.AddIgnoredActors(ignoredActors);
-
-	if (GetWorld()->LineTraceSingleByChannel(hit, start, end, ECC_WorldStatic, collisionParams))
-		return hit.ImpactPoint;
-	else
-		return point;
+	return FRealmGroundHeightfield::FindGroundBeneathPoint(GetWorld(), point, 100000.f);
 }
 
 void ASkill::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
@@ -276,5 +297,4 @@ void ASkill::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetim
 	DOREPLIFETIME(ASkill, characterOwner);
 	DOREPLIFETIME(ASkill, skillPoints);
 	DOREPLIFETIME(ASkill, skillState);
-	DOREPLIFETIME(ASkill, cooldownTime);
 }
\ No newline at end of file
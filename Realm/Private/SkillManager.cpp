@@ -4,38 +4,37 @@
 #include "Skill.h"
 #include "GameCharacter.h"
 
-ASkillManager::ASkillManager(const FObjectInitializer& objectInitializer)
+USkillManager::USkillManager(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
 {
-	bReplicates = true;
-	bAlwaysRelevant = true;
+
 }
 
-void ASkillManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
+void USkillManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ASkillManager, skills);
+	DOREPLIFETIME(USkillManager, skills);
 }
 
-void ASkillManager::AddSkill(ASkill* newSkill)
+void USkillManager::AddSkill(ASkill* newSkill)
 {
 	skills.AddUnique(newSkill);
 }
 
-void ASkillManager::ServerPerformSkill(int32 index, FVector mouseHitLoc, AGameCharacter* targetUnit)
+void USkillManager::ServerPerformSkill(int32 index, FVector mouseHitLoc, AGameCharacter* targetUnit)
 {
 	if (index < skills.Num())
 		skills[index]->ServerSkillPerformed(mouseHitLoc, targetUnit);
 }
 
-void ASkillManager::ClientPerformSkill(int32 index, FVector mouseHitLoc, AGameCharacter* targetUnit)
+void USkillManager::ClientPerformSkill(int32 index, FVector mouseHitLoc, AGameCharacter* targetUnit)
 {
 	if (index < skills.Num())
 		skills[index]->ClientSkillPerformed(mouseHitLoc, targetUnit);
 }
 
-ASkill* ASkillManager::GetSkill(int32 index)
+ASkill* USkillManager::GetSkill(int32 index)
 {
 	if (index < skills.Num())
 		return skills[index];
@@ -43,7 +42,18 @@ ASkill* ASkillManager::GetSkill(int32 index)
 		return nullptr;
 }
 
-void ASkillManager::GetSkills(TArray<ASkill*>& outSkills)
+void USkillManager::GetSkills(TArray<ASkill*>& outSkills)
 {
 	outSkills = skills;
+}
+
+void USkillManager::DestroySkills()
+{
+	for (ASkill* skill : skills)
+	{
+		if (IsValid(skill))
+			skill->Destroy();
+	}
+
+	skills.Empty();
 }
\ No newline at end of file
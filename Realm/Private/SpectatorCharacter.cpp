@@ -152,7 +152,7 @@ void ASpectatorCharacter::Tick(float deltaSeconds)
 		if (IsValid(pc))
 		{
 			FHitResult hit;
-			if (pc->SelectUnitUnderMouse(ECC_Visibility, true, hit) && IsValid(Cast<AGameCharacter>(hit.GetActor())) && !hit.GetActor()->bHidden)
+			if (pc->SelectUnitUnderMouse(ECC_Visibility, true, hit, false) && IsValid(Cast<AGameCharacter>(hit.GetActor())) && !hit.GetActor()->bHidden)
 				SetHoverTarget(Cast<AGameCharacter>(hit.GetActor()));
 			else
 				RemoveHoverTarget();
@@ -222,20 +222,13 @@ void ASpectatorCharacter::CalculateDirectedMove()
 
 	if (pc && pc->SelectUnitUnderMouse(ECC_Visibility, true, hit))
 	{
-		pc->ServerProcessSkillInputData(hit);
 		AGameCharacter* gc = Cast<AGameCharacter>(hit.GetActor());
-		if (IsValid(gc) && gc->IsAlive() && !gc->bHidden)
-		{
-			int32 team1 = gc->GetTeamIndex();
-			int32 team2 = pc->GetPlayerCharacter()->GetTeamIndex();
+		AGameCharacter* target = nullptr;
 
-			if (gc && team1 != team2)// && !playerController->IsCharacterOnTeam(mc->GetTeam()))
-				pc->ServerStartAutoAttack(gc);
-			else
-				pc->ServerMoveCommand(hit.ImpactPoint);
-		}
-		else
-			pc->ServerMoveCommand(hit.ImpactPoint);
+		if (IsValid(gc) && gc->IsAlive() && !gc->bHidden && IsValid(pc->GetPlayerCharacter()) && gc->GetTeamIndex() != pc->GetPlayerCharacter()->GetTeamIndex())
+			target = gc;
+
+		pc->SendDirectedCommand(hit.ImpactPoint, target, hit.GetActor());
 	}
 	else
 		UE_LOG(LogTemp, Warning, TEXT("Unable to get mouse coordiantes."));
@@ -286,6 +279,11 @@ void ASpectatorCharacter::ToggleMovementSystem(bool bEnabled)
 {
 	if (bEnabled)
 	{
+		//a fresh press always goes out, even if it's on the same spot as the last one
+		ARealmPlayerController* pc = Cast<ARealmPlayerController>(GetController());
+		if (IsValid(pc))
+			pc->ResetDirectedCommandFilter();
+
 		CalculateDirectedMove();
 
 		if (!GetWorldTimerManager().IsTimerActive(movementTimer))
@@ -9,7 +9,75 @@ UStatsManager::UStatsManager(const FObjectInitializer& objectInitializer)
 :Super(objectInitializer)
 {
 	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
+	{
+		baseStats[i] = 0.f;
+		modStats[i] = 0.f;
 		bonusStats[i] = 0.f;
+	}
+
+	effects.owner = this;
+}
+
+bool FReplicatedStat::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	//zigzag the fixed point value so small negative stats stay small on the wire
+	auto SerializeQuantized = [&Ar](float& value)
+	{
+		uint32 packed = 0;
+		if (Ar.IsSaving())
+		{
+			int32 fixed = FMath::RoundToInt(value * STAT_QUANTIZE_SCALE);
+			packed = (uint32)((fixed << 1) ^ (fixed >> 31));
+		}
+
+		Ar.SerializeIntPacked(packed);
+
+		if (Ar.IsLoading())
+		{
+			int32 fixed = (int32)(packed >> 1) ^ -(int32)(packed & 1);
+			value = fixed / STAT_QUANTIZE_SCALE;
+		}
+	};
+
+	uint8 flags = 0;
+	if (Ar.IsSaving())
+		flags = (modValue != 0.f ? 1 : 0) | (bonusValue != 0.f ? 2 : 0);
+
+	Ar.SerializeBits(&flags, 2);
+
+	SerializeQuantized(baseValue);
+
+	if (flags & 1)
+		SerializeQuantized(modValue);
+	else
+		modValue = 0.f;
+
+	if (flags & 2)
+		SerializeQuantized(bonusValue);
+	else
+		bonusValue = 0.f;
+
+	bOutSuccess = true;
+	return true;
+}
+
+void FEffectItem::PreReplicatedRemove(const FEffectList& list)
+{
+	if (IsValid(list.owner))
+		list.owner->OnEffectRemoved(effect, keyName);
+}
+
+void FEffectItem::PostReplicatedAdd(const FEffectList& list)
+{
+	if (IsValid(list.owner))
+		list.owner->OnEffectAdded(effect, keyName);
+}
+
+void FEffectItem::PostReplicatedChange(const FEffectList& list)
+{
+	//the effect actor may not have been around when the item was added
+	if (IsValid(list.owner))
+		list.owner->OnEffectAdded(effect, keyName);
 }
 
 void UStatsManager::SetMaxHealth()
@@ -22,7 +90,7 @@ void UStatsManager::SetMaxFlare()
 	flare = GetCurrentValueForStat(EStat::ES_Flare);
 }
 
-void UStatsManager::InitializeStats(float* initBaseStats, AGameCharacter* ownerChar)
+void UStatsManager::InitializeStats(const float* initBaseStats, AGameCharacter* ownerChar)
 {
 	if (bInitialized)
 		return;
@@ -91,7 +159,7 @@ AEffect* UStatsManager::AddEffect(FText const& effectName, FText const& effectDe
 	}
 
 	effectsMap.Add(keyName, newEffect);
-	effectsList.AddUnique(newEffect);
+	AddEffectItem(newEffect, keyName);
 
 	if (effectDuration > 0.f)
 		owningCharacter->GetWorldTimerManager().SetTimer(newEffect->effectTimer, FTimerDelegate::CreateUObject(this, &UStatsManager::EffectFinished, keyName), effectDuration, false);
@@ -132,7 +200,7 @@ void UStatsManager::EffectFinished(FString key)
 		
 
 	effectsMap.Remove(key);
-	effectsList.Remove(effect);
+	RemoveEffectItem(effect);
 
 	effect->SetLifeSpan(0.05f);
 
@@ -203,68 +271,95 @@ void UStatsManager::UpdateModStats(TArray<AMod*>& mods)
 	}
 }
 
-void UStatsManager::CharacterLevelUp()
+void UStatsManager::CharacterLevelUp(const float* previousLevelStats, const float* newLevelStats, int32 levelsGained)
 {
-	baseStats[(int32)EStat::ES_HP] += GetCurrentValueForStat(EStat::ES_HPPL);
-	health += GetCurrentValueForStat(EStat::ES_HPPL);
-	baseStats[(int32)EStat::ES_Flare] += GetCurrentValueForStat(EStat::ES_FlarePL);
-	flare += GetCurrentValueForStat(EStat::ES_FlarePL);
-
-	baseStats[(int32)EStat::ES_HPRegen] += GetCurrentValueForStat(EStat::ES_HPRegenPL);
-	baseStats[(int32)EStat::ES_FlareRegen] += GetCurrentValueForStat(EStat::ES_FlareRegenPL);
-	baseStats[(int32)EStat::ES_SpAtk] += GetCurrentValueForStat(EStat::ES_SpAtkPL);
-	baseStats[(int32)EStat::ES_Atk] += GetCurrentValueForStat(EStat::ES_AtkPL);
-	baseStats[(int32)EStat::ES_Def] += GetCurrentValueForStat(EStat::ES_DefPL);
-	baseStats[(int32)EStat::ES_SpDef] += GetCurrentValueForStat(EStat::ES_SpDefPL);
-	baseStats[(int32)EStat::ES_AtkSp] += GetCurrentValueForStat(EStat::ES_AtkSpPL);
-}
+	if (!previousLevelStats || !newLevelStats || levelsGained <= 0)
+		return;
 
-void UStatsManager::OnRepUpdateEffects()
-{
-	//check for removed effects
-	for (auto it = effectsMap.CreateIterator(); it; ++it)
+	for (int32 i = 0; i < LEVELED_STAT_COUNT; i++)
 	{
-		AEffect* hashEffect = it.Value();
+		const int32 stat = (int32)LEVELED_STATS[i][0];
+		const int32 perLevel = (int32)LEVELED_STATS[i][1];
 
-		if (!IsValid(hashEffect))
-			continue;
+		//the table has the base growth, mods and effects that add per level stats still count for every level gained
+		const float delta = (newLevelStats[stat] - previousLevelStats[stat]) + (modStats[perLevel] + bonusStats[perLevel]) * levelsGained;
+		baseStats[stat] += delta;
 
-		bool bFoundEffect = false;
-		for (int32 i = 0; i < effectsList.Num(); i++)
-		{
-			bFoundEffect = effectsList[i]->GetName() == hashEffect->GetName();
-			if (bFoundEffect)
-				break;
-		}
+		if (stat == (int32)EStat::ES_HP)
+			health += delta;
+		else if (stat == (int32)EStat::ES_Flare)
+			flare += delta;
+	}
+}
 
-		if (!bFoundEffect)
-		{
-			if (IsValid(hashEffect->currentEmitter))
-			{
-				hashEffect->currentEmitter->DeactivateSystem();
-				hashEffect->currentEmitter->DestroyComponent();
-			}
+void UStatsManager::UpdateReplicatedStats()
+{
+	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
+	{
+		FReplicatedStat stat(baseStats[i], modStats[i], bonusStats[i]);
 
-			hashEffect->Destroy(true);
-			effectsMap.Remove(it.Key());
-		}
+		//only touch entries that changed so untouched stats stay out of the bunch
+		if (!(stat == replicatedStats[i]))
+			replicatedStats[i] = stat;
 	}
+}
 
-	//add new effects
-	for (int32 i = 0; i < effectsList.Num(); i++)
+void UStatsManager::OnRepStats()
+{
+	for (int32 i = 0; i < (int32)EStat::ES_Max; i++)
 	{
-		AEffect* eff = effectsList[i];
-		if (!IsValid(eff))
-			continue;
+		baseStats[i] = replicatedStats[i].baseValue;
+		modStats[i] = replicatedStats[i].modValue;
+		bonusStats[i] = replicatedStats[i].bonusValue;
+	}
+}
 
-		if (!effectsMap.Contains(eff->GetName()))
-		{
-			if (IsValid(eff->effectParticle))
-				eff->currentEmitter = UGameplayStatics::SpawnEmitterAttached(eff->effectParticle, owningCharacter->GetRootComponent());
-			effectsMap.Add(eff->GetName(), eff);
-		}
+void UStatsManager::AddEffectItem(AEffect* effect, const FString& keyName)
+{
+	for (const FEffectItem& item : effects.items)
+	{
+		if (item.effect == effect)
+			return;
+	}
+
+	FEffectItem& item = effects.items[effects.items.AddDefaulted()];
+	item.effect = effect;
+	item.keyName = keyName;
+	effects.MarkItemDirty(item);
+}
+
+void UStatsManager::RemoveEffectItem(AEffect* effect)
+{
+	if (effects.items.RemoveAll([effect](const FEffectItem& item) { return item.effect == effect; }) > 0)
+		effects.MarkArrayDirty();
+}
+
+void UStatsManager::OnEffectAdded(AEffect* effect, const FString& keyName)
+{
+	if (!IsValid(effect) || effectsMap.FindRef(keyName) == effect)
+		return;
+
+	if (IsValid(effect->effectParticle) && IsValid(owningCharacter))
+		effect->currentEmitter = UGameplayStatics::SpawnEmitterAttached(effect->effectParticle, owningCharacter->GetRootComponent());
+
+	effectsMap.Add(keyName, effect);
+
+	if (IsValid(owningCharacter))
+		owningCharacter->EffectsUpdated();
+}
+
+void UStatsManager::OnEffectRemoved(AEffect* effect, const FString& keyName)
+{
+	if (IsValid(effect) && IsValid(effect->currentEmitter))
+	{
+		effect->currentEmitter->DeactivateSystem();
+		effect->currentEmitter->DestroyComponent();
+		effect->currentEmitter = nullptr;
 	}
 
+	if (effectsMap.FindRef(keyName) == effect)
+		effectsMap.Remove(keyName);
+
 	if (IsValid(owningCharacter))
 		owningCharacter->EffectsUpdated();
 }
@@ -286,7 +381,7 @@ void UStatsManager::AddCreatedEffect(AEffect* newEffect)
 			}
 		}
 
-		effectsList.AddUnique(newEffect);
+		AddEffectItem(newEffect, newEffect->keyName);
 		effectsMap.Add(newEffect->keyName, newEffect);
 
 		if (newEffect->duration > 0.f)
@@ -299,21 +394,21 @@ void UStatsManager::AddCreatedEffect(AEffect* newEffect)
 
 void UStatsManager::RemoveAllEffects(bool bFromDeath)
 {
-	for (int32 i = 0; i < effectsList.Num(); i++)
+	TArray<FString> finishedKeys;
+	for (const FEffectItem& item : effects.items)
 	{
-		if (bFromDeath)
-		{
-			if (IsValid(effectsList[i]) && !effectsList[i]->bPersistThroughDeath)
-				EffectFinished(effectsList[i]->keyName);
-		}
-		else
-		{
-			if (IsValid(effectsList[i]))
-				EffectFinished(effectsList[i]->keyName);
+		if (IsValid(item.effect) && (!bFromDeath || !item.effect->bPersistThroughDeath))
+			finishedKeys.Add(item.keyName);
+	}
 
-			effectsList.Empty();
-			effectsMap.Empty(0);
-		}
+	for (const FString& key : finishedKeys)
+		EffectFinished(key);
+
+	if (!bFromDeath)
+	{
+		effects.items.Empty();
+		effects.MarkArrayDirty();
+		effectsMap.Empty(0);
 	}
 
 	if (IsValid(owningCharacter))
@@ -322,27 +417,32 @@ void UStatsManager::RemoveAllEffects(bool bFromDeath)
 
 void UStatsManager::RemoveNegativeEffects()
 {
-	for (int32 i = 0; i < effectsList.Num(); i++)
+	TArray<FString> finishedKeys;
+	for (const FEffectItem& item : effects.items)
 	{
-		if (IsValid(effectsList[i]))
+		if (IsValid(item.effect))
 		{
-			for (float amt : effectsList[i]->amounts)
+			for (float amt : item.effect->amounts)
 			{
 				if (amt < 0.f)
-					EffectFinished(effectsList[i]->keyName);
+				{
+					finishedKeys.Add(item.keyName);
+					break;
+				}
 			}
 		}
 	}
+
+	for (const FString& key : finishedKeys)
+		EffectFinished(key);
 }
 
 void UStatsManager::GetLifetimeReplicatedProps(TArray< FLifetimeProperty > & OutLifetimeProps) const
 {
 	DOREPLIFETIME(UStatsManager, bInitialized);
-	DOREPLIFETIME(UStatsManager, baseStats);
-	DOREPLIFETIME(UStatsManager, modStats);
-	DOREPLIFETIME(UStatsManager, bonusStats);
+	DOREPLIFETIME(UStatsManager, replicatedStats);
 	DOREPLIFETIME(UStatsManager, health);
 	DOREPLIFETIME(UStatsManager, flare);
-	DOREPLIFETIME(UStatsManager, effectsList);
+	DOREPLIFETIME(UStatsManager, effects);
 	DOREPLIFETIME(UStatsManager, owningCharacter);
 }
\ No newline at end of file
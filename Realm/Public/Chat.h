@@ -2,6 +2,12 @@
 
 #include "Chat.generated.h"
 
+/* how many chat entries a game keeps around, older ones are overwritten */
+const static int32 CHAT_HISTORY_SIZE = 64;
+
+/* longest chat message the server will pass on */
+const static int32 CHAT_MAX_LENGTH = 200;
+
 UENUM()
 enum class EChatType : uint8
 {
@@ -19,10 +25,14 @@ struct FRealmChatEntry
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Chat)
 	TEnumAsByte<EChatType> chatType;
 
-	/* sender of the message */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Chat)
+	/* sender of the message, never sent over the network. clients fill it in from senderId when the chat arrives */
+	UPROPERTY(NotReplicated, EditAnywhere, BlueprintReadWrite, Category = Chat)
 	FString senderName;
 
+	/* player id of the sender's player state (-1 for the game itself) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Chat)
+	int32 senderId;
+
 	/* data of the message */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Chat)
 	FString chatData;
@@ -41,14 +51,21 @@ struct FRealmChatEntry
 
 	FRealmChatEntry()
 	{
-
+		chatType = EChatType::CT_PlayerChat;
+		senderId = -1;
+		timeStamp = 0.f;
+		bAllChat = true;
+		senderTeamIndex = -1;
 	}
 
 	FRealmChatEntry(TEnumAsByte<EChatType> ctype, const FString& sender, const FString& data, float time)
 	{
 		chatType = ctype;
 		senderName = sender;
+		senderId = -1;
 		chatData = data;
 		timeStamp = time;
+		bAllChat = true;
+		senderTeamIndex = -1;
 	}
 };
\ No newline at end of file
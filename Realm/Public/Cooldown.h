@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Cooldown.generated.h"
+
+/* one running cooldown in a character's cooldown table, stored as server timestamps so clients work out
+   progress from synced server time instead of running timers of their own */
+USTRUCT()
+struct FRealmCooldown
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* skill or mod that's cooling down */
+	UPROPERTY()
+	AActor* source;
+
+	/* server world time the cooldown started and ends */
+	UPROPERTY()
+	float startTime;
+
+	UPROPERTY()
+	float endTime;
+
+	FRealmCooldown()
+	{
+		source = nullptr;
+		startTime = 0.f;
+		endTime = 0.f;
+	}
+
+	FRealmCooldown(AActor* inSource, float start, float end)
+	{
+		source = inSource;
+		startTime = start;
+		endTime = end;
+	}
+
+	float GetRemaining(float serverTime) const
+	{
+		return FMath::Max(0.f, endTime - serverTime);
+	}
+
+	float GetProgressPercent(float serverTime) const
+	{
+		if (endTime <= startTime || serverTime >= endTime)
+			return 0.f;
+
+		return FMath::Clamp((serverTime - startTime) / (endTime - startTime), 0.f, 1.f);
+	}
+};
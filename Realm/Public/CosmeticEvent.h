@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CosmeticEvent.generated.h"
+
+class AGameCharacter;
+
+/* most events sent to a connection in one unreliable rpc, bigger batches are split */
+const static int32 COSMETIC_BATCH_SIZE = 32;
+
+UENUM()
+enum class ECosmeticEvent : uint8
+{
+	CE_PlayMontage UMETA(DisplayName = "Play Montage"),
+	CE_StopMontage UMETA(DisplayName = "Stop Montage"),
+	CE_Sound UMETA(DisplayName = "Sound"),
+	CE_AttachedSound UMETA(DisplayName = "Attached Sound"),
+	CE_Max UMETA(Hidden),
+};
+
+/* something a character does that only matters to clients that can see it, safe to drop */
+USTRUCT()
+struct FRealmCosmeticEvent
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* what to play */
+	UPROPERTY()
+	TEnumAsByte<ECosmeticEvent> eventType;
+
+	/* character playing the event */
+	UPROPERTY()
+	AGameCharacter* source;
+
+	/* montage or sound to play */
+	UPROPERTY()
+	UObject* asset;
+
+	/* play rate for montages */
+	UPROPERTY()
+	float playRate;
+
+	FRealmCosmeticEvent()
+	{
+		eventType = ECosmeticEvent::CE_Sound;
+		source = nullptr;
+		asset = nullptr;
+		playRate = 1.f;
+	}
+
+	FRealmCosmeticEvent(TEnumAsByte<ECosmeticEvent> type, AGameCharacter* inSource, UObject* inAsset, float rate = 1.f)
+	{
+		eventType = type;
+		source = inSource;
+		asset = inAsset;
+		playRate = rate;
+	}
+};
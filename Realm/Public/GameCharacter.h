@@ -9,6 +9,9 @@
 #include "Mod.h"
 #include "GameCharacterData.h"
 #include "ShieldManager.h"
+#include "CosmeticEvent.h"
+#include "Cooldown.h"
+#include "RealmDash.h"
 #include "GameCharacter.generated.h"
 
 /* max level for characters */
@@ -16,7 +19,6 @@ const static int32 MAX_LEVEL = 15;
 const static float EXP_CONST = 2.f / FMath::Sqrt(128.f);
 
 class URealmFogofWarManager;
-class UOverheadWidget;
 class UUserWidget;
 class AStealthArea;
 
@@ -126,7 +128,7 @@ protected:
 
 	/* skill manager this character can use */
 	UPROPERTY(replicated)
-	ASkillManager* skillManager;
+	USkillManager* skillManager;
 
 	/* mod manager this character can use */
 	UPROPERTY(replicated)
@@ -134,7 +136,7 @@ protected:
 	
 	/* shield manager this character can use */
 	UPROPERTY(replicated, BlueprintReadOnly, Category=Shield)
-	AShieldManager* shieldManager;
+	UShieldManager* shieldManager;
 
 	/* array of auto attacks this character can use */
 	UPROPERTY(EditDefaultsOnly, Category = AA)
@@ -156,6 +158,14 @@ protected:
 	UPROPERTY(replicated, VisibleAnywhere, Category = Mods)
 	TArray<AMod*> mods;
 
+	/* running cooldowns of this character's skills and mods, only changes when one starts */
+	UPROPERTY(replicated)
+	TArray<FRealmCooldown> cooldowns;
+
+	/* the last dash this character started, so clients can play it out locally instead of waiting on replicated movement */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_Dash)
+	FRealmDash replicatedDash;
+
 	/** Identifies if pawn is in its dying state */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Health)
 	uint32 bIsDying : 1;
@@ -258,14 +268,6 @@ protected:
 	UPROPERTY()
 	USoundAttenuation* soundAttenuation;
 
-	/* class of UI widget to display above the character's head */
-	UPROPERTY(EditDefaultsOnly, Category = UI)
-	TSubclassOf<UOverheadWidget> overheadWidgetClass;
-
-	/* UI widget to display above this character's head for UI info about them */
-	UPROPERTY()
-	UOverheadWidget* overheadWidget;
-
 	/* UI widget to display for this character on the minimap. Should probably make this base class in C++ eventually */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = UI)
 	TSubclassOf<UUserWidget> minimapIconClass;
@@ -274,7 +276,7 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Particles)
 	UParticleSystem* aaDamagedParticleSystem;
 
-	/* how many times the character's half height to place the overhead widget over head */
+	/* how many times the character's half height to place the overhead bars over head */
 	UPROPERTY(EditDefaultsOnly, Category = UI)
 	float overheadHalfHeightMultiplier;
 
@@ -306,6 +308,13 @@ protected:
 	UFUNCTION()
 	void OnRep_AutoAttackLaunching();
 
+	/* play a dash started on the server */
+	UFUNCTION()
+	void OnRep_Dash();
+
+	/* the owning player's prediction gets first say over replicated locations */
+	virtual void PostNetReceiveLocationAndRotation() override;
+
 	/* regen functions */
 	void HealthRegen();
 	void FlareRegen();
@@ -351,8 +360,15 @@ protected:
 
 public:
 
-	/* timers for auto attacks */
-	FTimerHandle aaRangeTimer, aaTimer, aaLaunchTimer;
+	/* auto attack timestamps in world time, stepped by the game mode's auto attack scheduler.
+	   the current launch lands at aaLaunchEndTime and the cooldown after it ends at aaCooldownEndTime */
+	float aaLaunchStartTime, aaLaunchEndTime, aaCooldownEndTime;
+
+	/* if range to the current target is being checked every frame */
+	bool bAutoAttackActive;
+
+	/* if the auto attack scheduler is stepping this character */
+	bool bInAutoAttackSchedule;
 
 	/* timer for actions */
 	UPROPERTY(BlueprintReadOnly, Category=Actions)
@@ -407,9 +423,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = AA)
 	virtual void StopAutoAttack(bool bClearCurrrentTarget = true);
 
-	/* this is called every 1/20th of a second while the auto attack is launched to make sure were still in range */
+	/* this is called every frame while the auto attack is active to make sure were still in range */
 	virtual void CheckAutoAttack();
 
+	/* [SERVER] steps this character's auto attack for the scheduler, finishing the launch or cooldown once its timestamp passes.
+	   returns false once there's nothing left to do */
+	bool UpdateAutoAttack(float currentTime);
+
+	/* start launching an auto attack at the current target, it lands after the attack speed scaled launch time */
+	void BeginAutoAttackLaunch();
+
+	/* how far along the current launch is, from 0 to 1 */
+	float GetAutoAttackLaunchProgress() const;
+
+	/* 2d distance from this character to the edge of another character's capsule */
+	float GetAutoAttackDistanceTo(AGameCharacter* other) const;
+
 	/* called to reset the cooldown timer for auto attacks (for skills) */
 	UFUNCTION(BlueprintCallable, Category = AA)
 	void ResetAutoAttack();
@@ -435,7 +464,7 @@ public:
 
 	/* get the skill manager */
 	UFUNCTION(BlueprintCallable, Category = Stats)
-	ASkillManager* GetSkillManager() const;
+	USkillManager* GetSkillManager() const;
 
 	/* gets the current value of the specified stat */
 	UFUNCTION(BlueprintCallable, Category = Stat)
@@ -496,9 +525,6 @@ public:
 	/** Returns True if the pawn can die in the current state */
 	virtual bool CanDie(float KillingDamage, FDamageEvent const& DamageEvent, APawn* Killer, AActor* DamageCauser) const;
 
-	/* let the specific classes have different character overlays */
-	virtual void PostRenderFor(class APlayerController* PC, class UCanvas* Canvas, FVector CameraPosition, FVector CameraDir) override;
-
 	/** Called on the actor right before replication occurs */
 	virtual void PreReplication(IRepChangedPropertyTracker & ChangedPropertyTracker) override;
 
@@ -636,14 +662,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = AutoAttack)
 	void PlayAutoAttackAnimation(float InPlayRate);
 
-	/* play animation */
-	UFUNCTION(NetMulticast, reliable, WithValidation)
+	/* play animation on every client that can see this character */
 	void AllPlayAnimMontage(class UAnimMontage* AnimMontage, float InPlayRate = 1.f);
 
-	/* stop animation */
-	UFUNCTION(NetMulticast, reliable, WithValidation)
+	/* stop animation on every client that can see this character */
 	void AllStopAnimMontage(class UAnimMontage* AnimMontage);
 
+	/* [SERVER] sends a cosmetic event through the game's cosmetic channel, clients just play it locally */
+	void QueueCosmeticEvent(const FRealmCosmeticEvent& cosmeticEvent);
+
+	/* [CLIENT] plays a cosmetic event the server sent */
+	void PlayCosmeticEvent(const FRealmCosmeticEvent& cosmeticEvent);
+
 	/* apply an action to this character */
 	UFUNCTION(BlueprintCallable, NetMulticast, reliable, Category = Action)
 	void ApplyCharacterAction(const FString& actionName, float actionDuration, bool bReverseProgressBar = false, bool bPreventCombat = false, bool bPreventMovement = false);
@@ -668,6 +698,21 @@ public:
 		return mods;
 	}
 
+	/* world time on the server, synced on clients through the game state */
+	float GetServerTime() const;
+
+	/* [SERVER] starts a skill's or mod's cooldown in the cooldown table */
+	void StartCooldown(AActor* source, float duration);
+
+	/* gets the table entry for a skill or mod, null if it has never cooled down */
+	const FRealmCooldown* FindCooldown(const AActor* source) const;
+
+	/* gets the seconds left on a skill's or mod's cooldown */
+	float GetCooldownRemaining(const AActor* source) const;
+
+	/* gets how far through its cooldown a skill or mod is, 0 when it isn't cooling down */
+	float GetCooldownProgressPercent(const AActor* source) const;
+
 	/* called in blueprints whenever this character needs to negate the next damage event */
 	UFUNCTION(BlueprintCallable, Category = Damage)
 	void SetNegateNextDamage()
@@ -682,6 +727,20 @@ public:
 		outText = characterName;
 	}
 
+	/* gets the world position the hud should draw this character's overhead bars at */
+	FVector GetOverheadLocation() const
+	{
+		FVector hudPos = GetActorLocation();
+		hudPos.Z += GetSimpleCollisionHalfHeight() * overheadHalfHeightMultiplier;
+		return hudPos;
+	}
+
+	/* get the shield manager */
+	UShieldManager* GetShieldManager() const
+	{
+		return shieldManager;
+	}
+
 	/* gets the name of a specified character class */
 	UFUNCTION(BlueprintCallable, Category = characterName)
 	static void GetCharacterClassName(TSubclassOf<AGameCharacter> characterClass, FText& outText)
@@ -708,8 +767,8 @@ public:
 	/* server function for upgrading skills*/
 	void OnUpgradeSkill(int32 index);
 
-	/* function to call for this character to play a sound over the network ONCE */
-	UFUNCTION(BlueprintCallable, reliable, NetMulticast, Category = CharacterSound)
+	/* function to call for this character to play a sound ONCE for every client that can see it */
+	UFUNCTION(BlueprintCallable, Category = CharacterSound)
 	void PlayCharacterSound(USoundBase* sound, bool bAttachedToCharacter = false);
 
 	/* requests to add a shield to the shield manager */
@@ -71,8 +71,22 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Portrait)
 	UTexture2D* portrait;
 
+	/* base stats for every level, MAX_LEVEL rows of ES_Max stats back to back. built once the stats are loaded and again
+	   whenever they're edited */
+	TArray<float> levelStatTable;
+
+	/* fills in the level table from the starting and per level stats */
+	void BuildLevelStatTable();
+
 public:
 
-	/* gets an array of stats to use for the game character class */
-	float* GetCharacterBaseStats() const;
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/* gets the base stats for a level (clamped to 1..MAX_LEVEL). points into the level table so nothing is allocated */
+	const float* GetBaseStatsForLevel(int32 level) const;
 };
\ No newline at end of file
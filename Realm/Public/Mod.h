@@ -32,15 +32,12 @@ protected:
 	TArray<TSubclassOf<AMod> > recipe;
 
 	/* reference to the character that owns this mod, if any */
-	UPROPERTY(BlueprintReadOnly, Category = Mod)
+	UPROPERTY(BlueprintReadOnly, replicated, Category = Mod)
 	AGameCharacter* characterOwner;
 
 	UPROPERTY()
 	FText statsDesc;
 
-	/* timer for cooldowns */
-	FTimerHandle cooldownTimer;
-
 public:
 
 	/* array of delta stats to add to the player */
@@ -106,8 +103,8 @@ public:
 		characterOwner = newOwner;
 	}
 
-	/* start cooldown for the skill */
-	UFUNCTION(reliable, NetMulticast, BlueprintCallable, Category=Mod)
+	/* [SERVER] start cooldown for the mod in its owner's cooldown table */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category=Mod)
 	void StartCooldown(float cooldownTime);
 
 	/* gets the percentage of cooldown progress */
@@ -81,7 +81,6 @@ public:
 	UFUNCTION(reliable, NetMulticast)
 	void StopBaseTeleport();
 
-	/* actually perform the base teleport */
-	UFUNCTION(reliable, NetMulticast)
+	/* [SERVER] actually perform the base teleport, the new location replicates on its own */
 	void PerformBaseTeleport();
 };
\ No newline at end of file
@@ -30,6 +30,67 @@ struct FUIDamage
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Damage")
 	FRealmDamage realmDamage;
+
+	/* character that received this damage. weak since the entry outlives dying minions by up to a second */
+	TWeakObjectPtr<AGameCharacter> damagedCharacter;
+
+	/* last time a hit was merged into this entry */
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	float lastHitTime;
+
+	/* how many hits have been merged into this entry */
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	int32 hitCount;
+
+	/* priority used to decide what gets evicted when the pool is full */
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	int32 priority;
+
+	/* whether or not this pool entry is currently showing */
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	bool bActive;
+
+	/* cached text for the amount, only rebuilt when the amount changes */
+	FText displayText;
+
+	FUIDamage()
+	{
+		amount = 0.f;
+		originTime = 0.f;
+		worldPosition = FVector::ZeroVector;
+		damagedCharacter = nullptr;
+		lastHitTime = 0.f;
+		hitCount = 0;
+		priority = 0;
+		bActive = false;
+	}
+};
+
+/* pooled name label drawn above a character's overhead bars */
+struct FOverheadLabel
+{
+	/* character this label was last built for, so the text can be reused between frames */
+	TWeakObjectPtr<AGameCharacter> labelOwner;
+
+	/* canvas item reused every frame */
+	FCanvasTextItem textItem;
+
+	FOverheadLabel()
+		: textItem(FVector2D::ZeroVector, FText::GetEmpty(), nullptr, FLinearColor::White)
+	{}
+};
+
+/* screen space bounds of a character the cursor can pick */
+struct FScreenPickEntry
+{
+	/* the list outlives the frame it was built in, so the character can be gone by the time it's picked */
+	TWeakObjectPtr<AGameCharacter> character;
+
+	/* bounds of the character's capsule on the screen */
+	FBox2D screenBounds;
+
+	/* squared distance from the camera, closer units win ties */
+	float cameraDistSq;
 };
 
 UCLASS(Blueprintable)
@@ -42,8 +103,43 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void DrawHUD() override;
 
+	/* fixed pool of floating combat text, entries are reused rather than created per hit */
 	TArray<FUIDamage> floatingDamage;
 
+	/* how many floating combat text entries can be on the screen at once */
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	int32 floatingDamagePoolSize;
+
+	/* hits on the same target within this window are summed into a single entry */
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float floatingDamageMergeWindow;
+
+	/* how long an entry stays on the screen after its last hit */
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float floatingDamageLifetime;
+
+	/* how fast the text floats up the screen */
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float floatingDamageRiseSpeed;
+
+	/* number of damage events that were summed into an existing entry */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	int32 mergedDamageEvents;
+
+	/* number of damage events that were thrown away because the pool was full of higher priority text */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	int32 droppedDamageEvents;
+
+	/* number of entries that were kicked out early for a higher priority event */
+	UPROPERTY(BlueprintReadOnly, Category = Damage)
+	int32 evictedDamageEvents;
+
+	/* gets the eviction priority for a damage event */
+	int32 GetFloatingDamagePriority(const FUIDamage& dmg) const;
+
+	/* draws and expires the active floating combat text */
+	void DrawFloatingDamage();
+
 	UPROPERTY()
 	UFont* uiFont;
 
@@ -62,9 +158,62 @@ protected:
 	/* gets the unit's heading */
 	float GetUnitHeading(AGameCharacter* unit) const;
 
+	/* alive characters that aren't hidden by the fog of war, gathered once per frame */
+	TArray<AGameCharacter*> visibleCharacters;
+
+	/* triangles for every overhead bar this frame, sent to the canvas as a single draw */
+	TArray<FCanvasUVTri> overheadBarTris;
+
+	/* pool of name labels, grows to the largest number of labels needed in a frame */
+	TArray<FOverheadLabel> overheadLabelPool;
+
+	/* number of pooled labels in use this frame */
+	int32 activeOverheadLabels;
+
+	/* size of the health bar above mythos */
+	UPROPERTY(EditDefaultsOnly, Category = Overhead)
+	FVector2D heroBarSize;
+
+	/* size of the health bar above minions and objectives */
+	UPROPERTY(EditDefaultsOnly, Category = Overhead)
+	FVector2D unitBarSize;
+
+	/* height of the flare bar drawn under a mythos' health bar */
+	UPROPERTY(EditDefaultsOnly, Category = Overhead)
+	float flareBarHeight;
+
+	/* targetable visible characters and their screen bounds, rebuilt every frame */
+	TArray<FScreenPickEntry> pickableCharacters;
+
+	/* extra pixels around each character's screen bounds so the cursor doesn't have to be exact */
+	UPROPERTY(EditDefaultsOnly, Category = Picking)
+	float pickPadding;
+
+	/* gathers the visible characters for this frame */
+	void GatherVisibleCharacters();
+
+	/* projects the visible characters' capsules to the screen for cursor picking */
+	void BuildPickableCharacters();
+
+	/* culls the visible characters against the screen and draws all of their overhead bars */
+	void DrawOverheadBars();
+
+	/* adds a colored quad to the overhead bar batch */
+	void AddOverheadQuad(const FVector2D& position, const FVector2D& size, const FLinearColor& color);
+
+	/* grabs a label from the pool and points it at the specified character */
+	void AddOverheadLabel(AGameCharacter* gc, const FVector2D& position, const FLinearColor& color);
+
 public:
 
-	void NewDamageEvent(FTakeHitInfo hitInfo, FVector worldPosition, FRealmDamage& realmdmg);
+	/* adds a damage event to the floating combat text, merging it into a recent hit on the same target if it can */
+	void NewDamageEvent(FTakeHitInfo hitInfo, AGameCharacter* damagedCharacter, FRealmDamage& realmdmg);
+
+	/* get the characters that can be picked by the cursor, as of the last frame drawn */
+	const TArray<FScreenPickEntry>& GetPickableCharacters() const
+	{
+		return pickableCharacters;
+	}
 
 	UFUNCTION(BlueprintImplementableEvent, Category = Store)
 	void InitIngameStore(const TArray<TSubclassOf<AMod> >& modStore);
@@ -99,10 +248,6 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = Postgame)
 	void NotifyEndGame(int32 teamVictor);
 
-	/* called when the hud needs to display damage text */
-	UFUNCTION(BlueprintImplementableEvent, Category = Damage)
-	void ShowDamageText(FUIDamage dmg);
-
 	/* called to show where and how many credits the player earned */
 	UFUNCTION(BlueprintImplementableEvent, Category = Credits)
 	void ShowCreditGain(const FVector& worldLoc, int32 creditAmt);
@@ -43,6 +43,18 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Damage)
 	FDamageRecap damageDesc;
 
+	/* [SERVER] how far back characters are rewound when checking hits, 0 if this projectile uses plain overlaps */
+	float hitRewindTime;
+
+	/* [SERVER] where the last rewound hit check ended */
+	FVector lastHitCheckLocation;
+
+	/* [SERVER] sweep what the projectile moved through since the last check against the rewound characters */
+	void CheckRewoundHits();
+
+	/* [SERVER] damage a character the projectile ran into */
+	void HitCharacter(AGameCharacter* gc);
+
 	virtual void Tick(float DeltaTime) override;
 	virtual void BeginPlay() override;
 
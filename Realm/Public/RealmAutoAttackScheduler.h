@@ -0,0 +1,45 @@
+#pragma once
+
+#include "RealmAutoAttackScheduler.generated.h"
+
+class ARealmGameMode;
+class AGameCharacter;
+class ARealmPlayerController;
+
+/* [SERVER] steps every character that is attacking, launching or cooling down in one pass per frame. range is measured
+   from the capsules instead of traced, and launches and cooldowns finish from timestamps on the character instead of each
+   attacker keeping its own 20hz range timer plus launch and cooldown timers */
+UCLASS()
+class URealmAutoAttackScheduler : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	/* characters with auto attack work this frame. removed once they're idle, order doesn't matter */
+	UPROPERTY()
+	TArray<AGameCharacter*> attackers;
+
+	/* players walking their hero into range of a target */
+	UPROPERTY()
+	TArray<ARealmPlayerController*> pursuers;
+
+public:
+
+	/* game mode that owns this scheduler */
+	UPROPERTY()
+	ARealmGameMode* gameOwner;
+
+	/* start stepping a character's auto attack, does nothing if it's already scheduled */
+	void AddAttacker(AGameCharacter* attacker);
+
+	/* start checking a player's range to its hero's target every frame */
+	void AddPursuer(ARealmPlayerController* pursuer);
+
+	/* step every scheduled attacker and pursuer */
+	void UpdateAutoAttacks();
+
+	/* number of characters currently scheduled */
+	UFUNCTION(BlueprintCallable, Category = AA)
+	int32 GetAttackerCount() const;
+};
@@ -3,6 +3,23 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "RealmCharacterMovementComponent.generated.h"
 
+class URealmLaneAvoidance;
+
+/* how fast dashes travel at a speed scale of 1 */
+const static float DASH_SPEED = 7100.f;
+
+/* where the locally predicted hero was at a point in time */
+struct FRealmSavedMove
+{
+	float timestamp;
+	FVector location;
+
+	FRealmSavedMove(float inTimestamp, const FVector& inLocation)
+		: timestamp(inTimestamp)
+		, location(inLocation)
+	{}
+};
+
 UCLASS()
 class URealmCharacterMovementComponent : public UCharacterMovementComponent
 {
@@ -24,6 +41,38 @@ protected:
 	/* current fly speed scale for dashes */
 	float flySpeedScale = 1.f;
 
+	/* [CLIENT] the local hero walking a move command before the server has seen it */
+	bool bPredictingMove;
+	int32 predictedCommandId;
+	TArray<FVector> predictedPath;
+	int32 predictedPathIndex;
+
+	/* [CLIENT] time the predicted path ran out, 0 while it's still being walked */
+	float predictionFinishedTime;
+
+	/* [CLIENT] recent predicted locations, oldest first */
+	TArray<FRealmSavedMove> savedMoves;
+
+	/* [CLIENT] correction from the server still to be blended in */
+	FVector pendingCorrection;
+
+	/* [CLIENT] a replicated dash being played out locally */
+	bool bSimulatingDash;
+	FVector simulatedDashEnd;
+	float simulatedDashSpeed;
+
+	void TickPredictedMove(float DeltaTime);
+	void TickSimulatedDash(float DeltaTime);
+
+	/* moves the capsule locally, sliding along anything in the way, and keeps it on the ground */
+	void MovePredicted(const FVector& delta, float DeltaTime);
+
+	/* where the prediction had the hero at a time, false if it's older than the saved moves go */
+	bool GetSavedLocationAtTime(float time, FVector& outLocation) const;
+
+	/* seconds between sending a command and the server's result of it arriving back */
+	float GetRoundTripTime() const;
+
 public:
 
 	/* override launch for our use */
@@ -39,4 +88,50 @@ public:
 
 	/* re enabale movement */
 	void ClearMovementIgnorance();
+
+	/* lane avoidance solver steering this character, and its slot there. null when it's left to the crowd simulation */
+	UPROPERTY()
+	URealmLaneAvoidance* laneAvoidance;
+	int32 avoidanceLane, avoidanceAgent;
+
+	/* path following's requested velocity goes through the lane avoidance solver when there is one */
+	virtual void RequestDirectMove(const FVector& MoveVelocity, bool bForceMaxSpeed) override;
+
+	/* [CLIENT] furthest the server can be from the prediction before it's abandoned for the replicated location */
+	float maxPredictionError;
+
+	/* [CLIENT] how quickly corrections from the server are blended in, per second */
+	float correctionRate;
+
+	/* [CLIENT] how long predicted locations are kept for reconciling */
+	float maxSavedMoveAge;
+
+	/* [CLIENT] start walking the local hero to a location straight away. the server still moves the hero itself, this only
+	   decides what the owning player sees until the server's positions catch up */
+	void StartPredictedMove(const FVector& targetLocation, int32 commandId);
+
+	/* [CLIENT] hand the hero back to the replicated movement */
+	void StopPredictedMove();
+
+	bool IsPredictingMove() const
+	{
+		return bPredictingMove;
+	}
+
+	int32 GetPredictedCommandId() const
+	{
+		return predictedCommandId;
+	}
+
+	/* [CLIENT] compare a replicated location with where the prediction had the hero when the server was there.
+	   returns true if the prediction is handling it and the replicated location shouldn't be applied */
+	bool ReconcileServerLocation(const FVector& serverLocation);
+
+	/* [CLIENT] play a dash out locally, skipping ahead by the time it's already been going on the server */
+	void SimulateDash(const FVector& startLocation, const FVector& endLocation, float speed, float elapsed);
+
+	bool IsSimulatingDash() const
+	{
+		return bSimulatingDash;
+	}
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "RealmMoveController.h"
+#include "RealmClientSignificanceManager.generated.h"
+
+class ARealmPlayerController;
+
+/* [CLIENT] picks how much animation work every character's mesh gets on this client from its screen size and whether fog hides it.
+   the local hero and anything it's fighting always animate at full rate, everything else falls back to update rate optimizations,
+   only ticking when rendered, and finally skipping animation ticks */
+UCLASS(BlueprintType)
+class URealmClientSignificanceManager : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	FTimerHandle significanceTimer;
+
+	/* tier each character's mesh was last set to, so settings are only touched when it changes */
+	TMap<TWeakObjectPtr<AGameCharacter>, ERealmSignificance> characterTiers;
+
+	/* number of characters in each tier after the last update */
+	int32 tierCounts[(uint8)ERealmSignificance::RS_MAX];
+
+	/* reclassify every character */
+	void UpdateSignificance();
+
+	/* whether the local player is controlling, targeting or being targeted by a character */
+	bool IsLocalCombatant(AGameCharacter* character, AGameCharacter* localHero) const;
+
+	/* how much of the screen's height a character's bounds take up */
+	float GetScreenSize(AGameCharacter* character, const FVector& cameraLocation, float tanHalfFOV) const;
+
+	/* changes the mesh settings for a tier */
+	void ApplyTier(AGameCharacter* character, ERealmSignificance tier);
+
+public:
+
+	/* local player this manager works for */
+	UPROPERTY()
+	ARealmPlayerController* playerOwner;
+
+	/* screen size at or above which a character animates at full rate */
+	float highScreenSize;
+
+	/* screen size below which a character skips animation ticks */
+	float lowScreenSize;
+
+	/* seconds between animation ticks for low significance meshes */
+	float lowAnimTickInterval;
+
+	/* seconds between updates */
+	float updateInterval;
+
+	/* starts the update timer */
+	void StartUpdatingSignificance();
+
+	/* gets how many characters were in a tier after the last update */
+	UFUNCTION(BlueprintCallable, Category = Significance)
+	int32 GetTierCount(ERealmSignificance tier) const;
+};
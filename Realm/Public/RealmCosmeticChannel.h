@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CosmeticEvent.h"
+#include "RealmCosmeticChannel.generated.h"
+
+class ARealmGameMode;
+class ARealmPlayerController;
+
+/* [SERVER] collects the cosmetic events characters play during a frame and sends each connection the ones it can see
+   in unreliable batches at the end of the frame. montages and sounds used to be reliable multicasts to everyone,
+   which filled up the reliable buffers with minion auto attacks nobody could see */
+UCLASS()
+class URealmCosmeticChannel : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	/* events queued since the last flush, in the order they happened */
+	TArray<FRealmCosmeticEvent> pendingEvents;
+
+	/* whether or not a player can see the character that played an event */
+	bool CanPlayerSeeEvent(ARealmPlayerController* pc, const FRealmCosmeticEvent& cosmeticEvent) const;
+
+public:
+
+	/* game mode that owns this channel */
+	UPROPERTY()
+	ARealmGameMode* gameOwner;
+
+	/* queue an event to be sent with this frame's batches */
+	void QueueEvent(const FRealmCosmeticEvent& cosmeticEvent);
+
+	/* send every player its batch of the queued events */
+	void FlushEvents();
+};
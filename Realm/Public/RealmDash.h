@@ -0,0 +1,38 @@
+#pragma once
+
+#include "RealmDash.generated.h"
+
+/* a dash the server started, replicated so clients play it out locally at full speed instead of
+   stepping through replicated positions a round trip late */
+USTRUCT()
+struct FRealmDash
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize startLocation;
+
+	UPROPERTY()
+	FVector_NetQuantize endLocation;
+
+	/* units per second the dash travels */
+	UPROPERTY()
+	float speed;
+
+	/* server world time the dash started, so late arrivals skip ahead to where the server is */
+	UPROPERTY()
+	float serverStartTime;
+
+	/* bumped every dash so the same dash twice in a row still replicates */
+	UPROPERTY()
+	uint8 dashCount;
+
+	FRealmDash()
+	{
+		startLocation = FVector::ZeroVector;
+		endLocation = FVector::ZeroVector;
+		speed = 0.f;
+		serverStartTime = 0.f;
+		dashCount = 0;
+	}
+};
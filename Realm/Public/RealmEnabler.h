@@ -20,6 +20,7 @@ protected:
 	float auraRange;
 
 	/* current protected units */
+	UPROPERTY()
 	TArray<APlayerCharacter*> protectedPlayers;
 
 	/* override for destruction and rewards */
@@ -28,9 +29,6 @@ protected:
 	/* let the specific classes have different character overlays */
 	//virtual void PostRenderFor(class APlayerController* PC, class UCanvas* Canvas, FVector CameraPosition, FVector CameraDir) override;
 
-	/* set the aura timer */
-	virtual void BeginPlay() override;
-	void OnTargetsUpdate();
 
 	/* function to go through and remove all aura effects */
 	void EnablerEffectFinished(AGameCharacter* gc);
@@ -40,4 +38,10 @@ public:
 	/* called whenever the player clicks on the store. we send back details of what to load and a reference to us */
 	void PlayerOpenedStore(ARealmPlayerController* pc);
 
+	/* allied mythos inside the aura range get the protection effect */
+	virtual float GetWatchedRange() const override;
+	virtual bool ShouldWatchUnit(AGameCharacter* unit) const override;
+	virtual void OnUnitEnteredRange(AGameCharacter* unit) override;
+	virtual void OnUnitLeftRange(AGameCharacter* unit) override;
+
 };
\ No newline at end of file
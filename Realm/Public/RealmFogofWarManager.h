@@ -5,6 +5,7 @@
 class AGameCharacter;
 class ARealmPlayerController;
 class ARealmGameMode;
+class FGameVisibilityWorker;
 
 USTRUCT()
 struct FTeamSightList
@@ -30,9 +31,15 @@ protected:
 	/* timer that calls for characters on the team to calculate visibiltiy */
 	FTimerHandle visibilityTimer;
 
+	/* this manager's visibility work, only ever one pass in flight per world */
+	FGameVisibilityWorker* visibilityWorker;
+
 	/* tell all of the characters to calculate visibility */
 	void CalculateTeamVisibility();
 
+	/* picks up a finished pass and hands the players their new sight lists, run on the game thread as soon as the pass completes */
+	void ApplyVisibilityResults();
+
 public:
 
 	/* team this sight manager is for , -1 for all characters */
@@ -73,38 +80,57 @@ public:
 	virtual void BeginDestroy() override;
 };
 
-/* multi-threaded class to calculate visibility for the fog of war manager, as running calculateVisibility on the gameThread causes a MASSIVE fps drop*/
-class FGameVisibilityWorker : public FRunnable
+/* calculates visibility for one fog of war manager on the task graph, as running calculateVisibility on the gameThread causes a MASSIVE fps drop.
+   each visibility tick launches a pass that splits the observers into chunks across worker threads, every chunk writing its own
+   sight lists which are merged at the end. the manager picks up the results from a game thread task that waits on the pass's completion event */
+class FGameVisibilityWorker
 {
-	/* runnable thread */
-	FRunnableThread* Thread;
+	/* completion fence for the pass in flight, null when nothing has been launched */
+	FGraphEventRef passCompletion;
 
-	/* the fog of war manager we're running this thread for */
-	URealmFogofWarManager* fogOfWar;
+	/* set when a finished pass hasn't been picked up yet */
+	bool bHasResults;
 
-	/* stop the thread if the manager is not valid anymore */
-	FThreadSafeCounter stopTaskCounter;
+	/* units this pass is calculating for, copied so the game thread can keep changing its own list */
+	TArray<AGameCharacter*> units;
 
-	/* pointer to the array of sight lists */
-	TArray<FTeamSightList>* enemySightLists;
+	/* merged sight lists this pass fills in */
+	TArray<FTeamSightList> sightLists;
+
+	/* sight lists for each chunk of observers, kept between passes so they don't reallocate */
+	TArray<TArray<FTeamSightList> > chunkSightLists;
 
 	/* calculate visibilities */
 	void CalculateVisibilities();
 
+	/* combine the chunks' lists into one list per team */
+	void MergeChunkSightLists();
+
 public:
 
-	/** Singleton instance, can access the thread any time via static accessor, if it is active! */
-	static FGameVisibilityWorker* runnable;
+	/* observers handled by each parallel chunk */
+	static const int32 ObserversPerChunk = 8;
 
-	FGameVisibilityWorker(URealmFogofWarManager* inFoW, TArray<FTeamSightList>& sightLists);
-	virtual ~FGameVisibilityWorker();
+	FGameVisibilityWorker();
+	~FGameVisibilityWorker();
 
-	virtual bool Init();
-	virtual uint32 Run();
-	virtual void Stop();
+	bool IsBusy() const
+	{
+		return passCompletion.GetReference() && !passCompletion->IsComplete();
+	}
 
-	void EnsureCompletion();
+	/* launches a pass for the given units. does nothing if one is already in flight */
+	void LaunchPass(const TArray<AGameCharacter*>& inUnits, int32 sightListCount);
+
+	/* completion event of the pass in flight, null if nothing has been launched */
+	FGraphEventRef GetPassCompletion() const
+	{
+		return passCompletion;
+	}
 
-	static FGameVisibilityWorker* WorkerInit(URealmFogofWarManager* inFoW);
-	static void Shutdown();
+	/* swaps the finished sight lists out, returns false if there's nothing new */
+	bool TakeResults(TArray<FTeamSightList>& outSightLists);
+
+	/* waits for the pass in flight so the manager can be destroyed */
+	void EnsureCompletion();
 };
\ No newline at end of file
@@ -36,6 +36,8 @@ protected:
 	/* target out of aggro range */
 	void ReevaluateTargets();
 
+	virtual void OnSignificanceChanged(ERealmSignificance oldSignificance) override;
+
 public:
 
 	/* home vector of this minion */
@@ -10,6 +10,23 @@
 #include "RealmGameInstance.generated.h"
 
 class ARealmGameMode;
+class ARealmMainMenu;
+
+/* one handler slot for every possible lobby message id */
+const static int32 LOBBY_HANDLER_COUNT = 256;
+
+/* seconds a lobby request waits for its answer before it's given up on */
+const static float LOBBY_REQUEST_TIMEOUT = 30.f;
+
+/* a lobby request still waiting on its answer */
+struct FPendingLobbyRequest
+{
+	ELobbyMessage messageId;
+	double sendTime;
+
+	/* connection it went out on, so a dropped connection can forget what was in flight on it */
+	FRealmSocketListener* connection;
+};
 
 UCLASS()
 class URealmGameInstance : public UGameInstance
@@ -38,26 +55,86 @@ protected:
 	UPROPERTY(BlueprintReadOnly, Category = RealmInstance)
 	int32 currentPlayerDivision;
 
-	/* socket connection to the login server */
+	/* persistent connections to the login and multiplayer servers, created the first time they're needed */
 	FRealmSocketListener* loginSocketThread;
 	FRealmSocketListener* multiplayerSocketThread;
 
-	FSocket* loginSocket;
-	FSocket* multiplayerSocket;
+	FTimerHandle loginSocketListenTimer, multiplayerSocketListenTimer;
+
+	/* correlation id for the next request, responses echo it back */
+	uint32 nextCorrelationId;
 
-	FIPv4Endpoint RemoteAddressForConnection;
+	/* requests that haven't been answered yet, by correlation id */
+	TMap<uint32, FPendingLobbyRequest> pendingLobbyRequests;
 
-	FTimerHandle loginSocketListenTimer, multiplayerSocketListenTimer;
+	/* whether each connection was up the last time it was polled, to notice when it drops */
+	bool bLoginSocketWasConnected, bMultiplayerSocketWasConnected;
+
+	/* handlers for incoming lobby messages, indexed by message id */
+	typedef void (URealmGameInstance::*FLobbyHandler)(const FLobbyMessage&);
+	FLobbyHandler lobbyHandlers[LOBBY_HANDLER_COUNT];
+
+	/* tags a request with a correlation id and queues it on the connection. returns the id, or 0 if it couldn't be sent */
+	uint32 SendLobbyRequest(FRealmSocketListener* connection, FLobbyMessage& request);
+
+	/* queues a message the server never answers. it goes out with correlation id 0 and isn't tracked */
+	bool SendLobbyNotification(FRealmSocketListener* connection, FLobbyMessage& notification);
+
+	/* forgets requests on a connection that have timed out, or all of them if the connection dropped since they were sent */
+	void ExpireLobbyRequests(FRealmSocketListener* connection, bool& bWasConnected);
 
-	FString StringFromBinaryArray(const TArray<uint8>& BinaryArray);
+	/* runs the handler for a message pulled off one of the connections */
+	void DispatchLobbyMessage(const FLobbyMessage& message);
 
-	void SetupInternetAddresses();
+	/* gets the main menu game mode if we're in the menu */
+	ARealmMainMenu* GetMainMenu() const;
 
+	/* lobby message handlers */
+	void OnLoginSuccess(const FLobbyMessage& message);
+	void OnLoginFailure(const FLobbyMessage& message);
+	void OnCreateLoginSuccess(const FLobbyMessage& message);
+	void OnCreateLoginFailure(const FLobbyMessage& message);
+	void OnUpdateInfo(const FLobbyMessage& message);
+	void OnJoinedQueueSuccessfully(const FLobbyMessage& message);
+	void OnJoinedQueueFailed(const FLobbyMessage& message);
+	void OnFoundMatch(const FLobbyMessage& message);
+	void OnFoundMatchConfirmed(const FLobbyMessage& message);
+	void OnMatchConfirmFailed(const FLobbyMessage& message);
+
+	/* sha1 hex digest of a password, the server never sees the plain text */
+	static FString HashPassword(const FString& password);
+
+	/* make sure the connection exists and its data is being polled. never blocks, requests queue until it's connected */
 	bool ConnectLoginSocket();
 	bool ConnectMultiplayerSocket();
 	void ListenLoginSocket();
 	void ListenMultiplayerSocket();
 
+	/* start resolving the lobby and game server hosts so the cache is warm */
+	virtual void Init() override;
+
+	/* whether or not this dedicated server resets for another match instead of exiting, set with -recycle */
+	bool bRecycleServer;
+
+	/* when the current recycle started, 0 until the first one */
+	double recycleStartTime;
+
+	/* time-to-ready of the boot and the running average of the recycles, in seconds */
+	float coldStartReadyTime;
+	float averageWarmReadyTime;
+	int32 warmRecycleCount;
+
+	/* gameplay classes kept referenced across recycles so they don't unload and reload with the map */
+	UPROPERTY()
+	TArray<UObject*> warmAssets;
+
+	/* holds on to the classes this game mode uses */
+	void KeepAssetsWarm(ARealmGameMode* gameMode);
+
+	/* sends the players back to the menu and reloads the map, with the same options, in this process for the next match.
+	   saves the process start and engine init, not the map load */
+	void RecycleServer();
+
 	void ReceiveInfoUpdate(const FString& alias, int32 mp);
 
 public:
@@ -92,8 +169,8 @@ public:
 	UFUNCTION(BlueprintCallable, Category=Game)
 	static FString GetRealmServerIP(int32 port);
 
-	void ParseLoginSocketData(const TArray<uint8>& data);
-	void ParseMultiplayerSocketData(const TArray<uint8>& data);
-
 	void CloseGameInstance();
+
+	/* called by the game mode when a fresh match is waiting for players, reports time-to-ready and tells the matchmaker this server can take a match */
+	void ServerReadyForMatch(ARealmGameMode* gameMode);
 };
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "GameFramework/GameState.h"
+#include "Chat.h"
+#include "RealmGroundHeightfield.h"
 #include "RealmGameState.generated.h"
 
-struct FRealmChatEntry;
+class ARealmPlayerState;
 
 UCLASS()
 class ARealmGameState : public AGameState
@@ -22,20 +24,39 @@ protected:
 	UPROPERTY(replicated)
 	TArray<int32> teamScores;
 
-	/* array of chat entries for this game */
+	/* ring buffer of the most recent chat entries for this game */
 	UPROPERTY()
 	TArray<FRealmChatEntry> gameChat;
 
+	/* slot the next chat entry goes in */
+	int32 gameChatHead;
+
 public:
 
+	/* ground heights baked from the level when play starts, on the server and every client */
+	TUniquePtr<FRealmGroundHeightfield> groundHeightfield;
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	/** broadcast death for objective to local clients */
 	UFUNCTION(Reliable, NetMulticast)
 	void BroadcastObjectiveDeath(APawn* killerPawn, ARealmObjective* objectiveDestroyed);
 
-	/* broadcast chat from a source and then notify each player */
-	UFUNCTION(reliable, NetMulticast, BlueprintCallable, Category = Chat)
+	/* [SERVER] sends chat only to the players who should see it, everyone for all chat or the sender's team otherwise */
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = Chat)
 	void BroadcastChat(const FRealmChatEntry& broadcastChat);
 
+	/* keeps a chat entry in the history, overwriting the oldest one once it's full */
+	void AddChatToHistory(const FRealmChatEntry& chatEntry);
+
+	/* gets the chat history, oldest first */
+	UFUNCTION(BlueprintCallable, Category = Chat)
+	void GetChatHistory(TArray<FRealmChatEntry>& outHistory) const;
+
+	/* finds the player state a chat sender id belongs to */
+	ARealmPlayerState* FindPlayerStateById(int32 playerId) const;
+
 	/* gets the amount of time that has passed between now and when the match started */
 	UFUNCTION(BlueprintCallable, Category = GameTime)
 	float GetMatchTime() const;
@@ -0,0 +1,54 @@
+#pragma once
+
+/* height of the level's static ground on a regular grid, baked once when the level starts so ground queries for skills
+   don't have to trace through every character and projectile in the world. lookups interpolate between the four
+   surrounding samples and only fall back to a trace outside the baked area, over holes, under overhangs, or across
+   steps too steep to interpolate */
+class FRealmGroundHeightfield
+{
+	/* world space corner of the first sample and distance between samples */
+	FVector2D origin;
+	float cellSize;
+
+	/* number of samples along each axis */
+	int32 sizeX;
+	int32 sizeY;
+
+	/* ground height of each sample, row major */
+	TArray<float> heights;
+
+	/* whether each sample found ground */
+	TBitArray<> validSamples;
+
+	/* top of the baked geometry, where bake traces start from */
+	float traceTop;
+
+	/* traces straight down through static geometry only */
+	static bool TraceGround(UWorld* world, const FVector& start, float traceDistance, FVector& outLocation);
+
+public:
+
+	/* distance between samples the bake starts with, doubled until the grid fits in MaxSamplesPerAxis */
+	static const float DefaultCellSize;
+	static const int32 MaxSamplesPerAxis = 512;
+
+	/* biggest height difference between neighbouring samples that's still interpolated */
+	static const float MaxInterpolatedStep;
+
+	FRealmGroundHeightfield();
+
+	/* bakes the heightfield from the static world geometry of the level */
+	void Bake(UWorld* world);
+
+	bool IsBaked() const
+	{
+		return heights.Num() > 0;
+	}
+
+	/* gets the baked ground height beneath a point, returns false when the point needs a trace instead */
+	bool GetGroundHeight(const FVector& point, float& outHeight) const;
+
+	/* gets the ground beneath a point from the world's heightfield, tracing if it isn't baked there.
+	   returns the point itself if there's no ground within trace distance */
+	static FVector FindGroundBeneathPoint(UWorld* world, const FVector& point, float traceDistance);
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "RealmLagCompensation.generated.h"
+
+class ARealmGameMode;
+class AGameCharacter;
+
+/* frames of positions kept for every character */
+const static int32 LAG_COMPENSATION_HISTORY_SIZE = 32;
+
+/* positions are recorded at most this often, so the history always spans at least LAG_COMPENSATION_HISTORY_SIZE of these */
+const static float LAG_COMPENSATION_MIN_INTERVAL = 1.f / 60.f;
+
+/* furthest back a shot is ever checked, whatever the shooter's ping */
+const static float LAG_COMPENSATION_MAX_REWIND = 0.4f;
+
+/* recent positions of one character, indexed by frame the same as the frame times */
+struct FRealmPositionHistory
+{
+	TWeakObjectPtr<AGameCharacter> character;
+
+	/* collision of the capsule, characters don't change size mid match */
+	float radius;
+	float halfHeight;
+
+	/* first frame this character was recorded in */
+	int32 firstFrame;
+
+	/* last frame this character was recorded in, anything older than the current frame has left the game */
+	int32 lastFrame;
+
+	/* first frame after the character last teleported, rewinds never blend into it. INDEX_NONE if it hasn't */
+	int32 teleportFrame;
+
+	FVector locations[LAG_COMPENSATION_HISTORY_SIZE];
+};
+
+/* [SERVER] keeps a short history of where every character was, so shots from players can be checked against what the
+   shooter was actually looking at rather than where the targets have moved to since. a fixed number of frames is kept
+   per character, about half a kilobyte each, and rewinds are capped at LAG_COMPENSATION_MAX_REWIND */
+UCLASS()
+class URealmLagCompensation : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	/* server time of each recorded frame */
+	float frameTimes[LAG_COMPENSATION_HISTORY_SIZE];
+
+	/* frames recorded so far, frame n lives at n % LAG_COMPENSATION_HISTORY_SIZE */
+	int32 frameCount;
+
+	TArray<FRealmPositionHistory> histories;
+	TMap<AGameCharacter*, int32> historyIndices;
+
+	/* oldest frame still in the history */
+	int32 GetOldestFrame() const
+	{
+		return FMath::Max(0, frameCount - LAG_COMPENSATION_HISTORY_SIZE);
+	}
+
+	/* drop characters that weren't recorded this frame */
+	void RemoveStaleHistories();
+
+	/* where a character was at a server time, clamped to the oldest frame it has */
+	FVector GetRewoundLocation(const FRealmPositionHistory& history, float time) const;
+
+public:
+
+	/* game mode that owns this history */
+	UPROPERTY()
+	ARealmGameMode* gameOwner;
+
+	/* record where every character is this frame */
+	void RecordPositions();
+
+	/* a character has jumped somewhere rather than moved there (a respawn or base teleport), so rewinds across the jump
+	   snap to one side of it instead of passing through everything in between */
+	void MarkTeleported(AGameCharacter* character);
+
+	/* how far back to check a shot from this shooter, its player's round trip capped to the rewind window. 0 for shots from
+	   the ai, and when lag compensation is turned off */
+	float GetRewindTime(AActor* shooter) const;
+
+	/* sweep a sphere against the characters' capsules as they were rewindTime ago. only characters are tested, the hits are
+	   ordered along the sweep and ignoredActor is skipped. returns true if anything was hit */
+	bool SweepCharacters(AActor* ignoredActor, const FVector& start, const FVector& end, float radius, float rewindTime, TArray<FHitResult>& hitsOut) const;
+
+	/* the lag compensation of the server's game, null on clients */
+	static URealmLagCompensation* Get(UWorld* world);
+
+	/* the character a shot belongs to, following the owners of skills and projectiles */
+	static AGameCharacter* GetShooterCharacter(AActor* shooter);
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "RealmLaneAvoidance.generated.h"
+
+class ARealmGameMode;
+class AGameCharacter;
+class ALaneManager;
+class URealmCharacterMovementComponent;
+
+DECLARE_STATS_GROUP(TEXT("RealmAvoidance"), STATGROUP_RealmAvoidance, STATCAT_Advanced);
+
+/* most neighbors an agent considers when it's solved, the closest aren't picked so keep this comfortably above a wave's clump size */
+const static int32 LANE_AVOIDANCE_MAX_NEIGHBORS = 16;
+
+/* tuning shared by every lane */
+struct FLaneAvoidanceParams
+{
+	/* how far ahead collisions are looked for, in seconds */
+	float timeHorizon;
+
+	/* agents further than this aren't considered at all */
+	float neighborRadius;
+
+	/* share of each avoidance an agent takes on, the other agent is expected to do the rest */
+	float reciprocity;
+
+	FLaneAvoidanceParams()
+		: timeHorizon(1.5f)
+		, neighborRadius(400.f)
+		, reciprocity(0.5f)
+	{}
+};
+
+/* one lane's agents as structure of arrays so a solve streams through flat float arrays instead of chasing actors */
+struct FLaneAvoidanceAgents
+{
+	/* where every agent is and how fast it's actually moving, gathered at the start of each update */
+	TArray<float> positionX, positionY;
+	TArray<float> velocityX, velocityY;
+
+	/* velocity each agent's path following last asked for */
+	TArray<float> preferredX, preferredY;
+
+	/* correction the last solve came up with, added to the preferred velocity until the agent is solved again */
+	TArray<float> steerX, steerY;
+
+	TArray<float> radius, maxSpeed;
+
+	/* agents steer around others whose avoidance group shares a bit with their groups to avoid */
+	TArray<uint32> avoidanceGroup, groupsToAvoid;
+
+	/* agent that each slot belongs to, only touched while gathering */
+	TArray<TWeakObjectPtr<AGameCharacter> > characters;
+
+	/* next agent to solve when the budget doesn't cover the whole lane */
+	int32 nextAgent;
+
+	FLaneAvoidanceAgents()
+		: nextAgent(0)
+	{}
+
+	int32 Num() const
+	{
+		return positionX.Num();
+	}
+
+	int32 Add(AGameCharacter* character, float inRadius, float inMaxSpeed, uint32 inAvoidanceGroup, uint32 inGroupsToAvoid);
+	void RemoveAtSwap(int32 index);
+
+	/* work out an agent's steer from its neighbors, four at a time */
+	void SolveAgent(int32 index, const FLaneAvoidanceParams& params);
+
+	/* the same solve one neighbor at a time, kept as the reference for the benchmark */
+	void SolveAgentScalar(int32 index, const FLaneAvoidanceParams& params);
+};
+
+/* [SERVER] local avoidance for lane minions. every lane's agents are solved in one pass over their arrays at the end of
+   the frame with a budget on how many agents get solved, instead of each minion running a detour crowd avoidance query.
+   minions only avoid their own team, enemies are meant to run into each other */
+UCLASS()
+class URealmLaneAvoidance : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	/* one entry per lane, a team's lane manager and its enemy lane share one */
+	TArray<FLaneAvoidanceAgents> lanes;
+	TArray<ALaneManager*> laneKeys;
+
+	/* lane the budget starts on next update, so one busy lane can't starve the others */
+	int32 nextLane;
+
+	/* copy every agent's position and velocity in, dropping the ones that have died */
+	void GatherAgents(FLaneAvoidanceAgents& lane);
+
+public:
+
+	/* game mode that owns this solver */
+	UPROPERTY()
+	ARealmGameMode* gameOwner;
+
+	FLaneAvoidanceParams params;
+
+	/* most agents solved in one update, the rest keep their last steer */
+	int32 maxAgentsPerUpdate;
+
+	/* start steering a lane minion, taking it off the crowd simulation */
+	void AddAgent(AGameCharacter* character, ALaneManager* lane);
+
+	/* solve this frame's share of every lane */
+	void UpdateAvoidance();
+
+	/* record the velocity an agent's path following wants and return it with the agent's steer applied */
+	FVector ApplyAvoidance(int32 laneIndex, int32 agentIndex, const FVector& preferredVelocity);
+
+	/* whether new lane minions should use this solver rather than the crowd simulation */
+	static bool IsEnabled();
+};
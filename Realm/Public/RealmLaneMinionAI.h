@@ -86,6 +86,8 @@ protected:
 	/* set a new target for this minion */
 	void SetNewTarget(AGameCharacter* newTarget, ELaneMinionTargetPriority targetPriority);
 
+	virtual void OnSignificanceChanged(ERealmSignificance oldSignificance) override;
+
 public:
 
 	virtual void Possess(APawn* InPawn) override;
@@ -0,0 +1,112 @@
+#pragma once
+
+/* ports the login and multiplayer servers listen on */
+const static int32 LOGIN_PORT = 3308;
+const static int32 MULTIPLAYER_PORT = 3310;
+
+/* ids for every message sent to or from the login and multiplayer servers */
+enum class ELobbyMessage : uint8
+{
+	None = 0,
+
+	//requests
+	Login = 1,
+	LoginCreate = 2,
+	GetInfoUpdate = 3,
+	JoinQueue = 4,
+	ConfirmMatch = 5,
+	RankedGameFinished = 6,
+	ServerReady = 7,
+
+	//responses and pushes
+	LoginSuccess = 64,
+	LoginFailure = 65,
+	CreateLoginSuccess = 66,
+	CreateLoginFailure = 67,
+	UpdateInfo = 68,
+	JoinedQueueSuccessfully = 69,
+	JoinedQueueFailed = 70,
+	FoundMatch = 71,
+	FoundMatchConfirmed = 72,
+	MatchConfirmFailed = 73,
+
+	Max = 255
+};
+
+/* a single decoded lobby message. responses carry the correlation id of the request they answer,
+   messages the server sends on its own use 0 */
+struct FLobbyMessage
+{
+	ELobbyMessage messageId;
+	uint32 correlationId;
+
+	/* raw field data, read back with the typed getters */
+	TArray<TArray<uint8> > fields;
+
+	FLobbyMessage()
+		: messageId(ELobbyMessage::None)
+		, correlationId(0)
+	{}
+
+	explicit FLobbyMessage(ELobbyMessage inMessageId, uint32 inCorrelationId = 0)
+		: messageId(inMessageId)
+		, correlationId(inCorrelationId)
+	{}
+
+	/* append a utf8 string field */
+	FLobbyMessage& AddString(const FString& value);
+
+	/* append a 4 byte integer field */
+	FLobbyMessage& AddInt(int32 value);
+
+	/* read a field back, missing or malformed fields come back empty/zero */
+	FString GetString(int32 index) const;
+	int32 GetInt(int32 index) const;
+
+	int32 NumFields() const
+	{
+		return fields.Num();
+	}
+};
+
+/* frames lobby messages on a tcp stream
+   frame: [uint32 length of the rest][uint8 message id][uint32 correlation id][uint8 field count]([uint16 field length][field bytes])...
+   all integers are little endian */
+class FLobbyCodec
+{
+	/* bytes received that haven't been turned into messages yet */
+	TArray<uint8> streamBuffer;
+
+	/* set when a frame couldn't possibly be valid, the connection should be dropped */
+	bool bCorrupt;
+
+public:
+
+	/* largest frame we'll accept before deciding the stream is garbage */
+	static const uint32 MaxFrameSize = 64 * 1024;
+
+	FLobbyCodec()
+		: bCorrupt(false)
+	{}
+
+	/* encode a message into a complete frame */
+	static void Encode(const FLobbyMessage& message, TArray<uint8>& outData);
+
+	/* add data read from the socket. reads can hold part of a frame or several frames */
+	void AppendData(const uint8* data, int32 num);
+
+	/* pull the next complete message out of the stream, returns false when more data is needed */
+	bool NextMessage(FLobbyMessage& outMessage);
+
+	bool IsCorrupt() const
+	{
+		return bCorrupt;
+	}
+
+	/* throw away any buffered data, used when the connection is reset */
+	void Reset()
+	{
+		streamBuffer.Reset();
+		bCorrupt = false;
+	}
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "Networking.h"
+#include "RealmLobbyProtocol.h"
+
+class FRealmSocketListener;
+
+/* local stand-in for the login and multiplayer servers so the lobby path can be run without the live backend.
+   answers every request the game sends, and can be told to fail a share of them to exercise the error paths.
+   started with realm.LobbyStandIn.Start, point the game at it with realm.LobbyHost 127.0.0.1 */
+class FRealmLobbyStandIn : public FRunnable
+{
+	struct FStandInClient
+	{
+		FSocket* socket;
+		FLobbyCodec codec;
+
+		/* encoded responses the socket hasn't taken yet, sent ahead of anything new so frames never interleave */
+		TArray<uint8> sendBuffer;
+
+		/* when to push a found match for a queued client, 0 if it isn't queued */
+		double matchPushTime;
+
+		FStandInClient()
+			: socket(nullptr)
+			, matchPushTime(0.0)
+		{}
+	};
+
+	FRunnableThread* serverThread;
+	FThreadSafeCounter stopServerThread;
+
+	/* one listen socket per port so both lobby connections can point at the same stand-in */
+	TArray<FSocket*> listenSockets;
+	TArray<FStandInClient*> clients;
+
+	/* percent of requests answered with the failure response */
+	int32 failPercent;
+
+	/* seconds between joining the queue and the found match push */
+	float matchDelay;
+
+	/* counters, read from the game thread */
+	FThreadSafeCounter requestsHandled;
+	FThreadSafeCounter connectionsAccepted;
+
+	FRandomStream random;
+
+	void AcceptConnections();
+
+	/* reads and answers everything a client has sent, returns false if it disconnected */
+	bool ServiceClient(FStandInClient& client);
+
+	/* returns false if the client has to be dropped */
+	bool HandleRequest(FStandInClient& client, const FLobbyMessage& request);
+
+	/* queues a message behind anything still unsent and sends what the socket will take. returns false if the client
+	   has to be dropped */
+	bool SendMessage(FStandInClient& client, const FLobbyMessage& message);
+
+	bool ShouldFail();
+
+	void CloseAll();
+
+public:
+
+	FRealmLobbyStandIn(const TArray<int32>& ports, int32 inFailPercent, float inMatchDelay);
+	virtual ~FRealmLobbyStandIn();
+
+	// Begin FRunnable interface.
+	virtual uint32 Run();
+	virtual void Stop();
+	// End FRunnable interface
+
+	void EnsureCompletion();
+
+	/* whether or not every port could be bound */
+	bool IsListening() const
+	{
+		return listenSockets.Num() > 0;
+	}
+
+	int32 GetRequestsHandled() const
+	{
+		return requestsHandled.GetValue();
+	}
+
+	int32 GetConnectionsAccepted() const
+	{
+		return connectionsAccepted.GetValue();
+	}
+};
+
+/* drives a batch of simulated clients against a lobby server and reports request latency and throughput. every client
+   is an FRealmSocketListener, the same connection the game uses, so its queues, framing, reconnects and poll interval
+   are all part of what's measured. each client keeps one request in flight, cycling login, info update, join queue and
+   confirm match. started with realm.LobbyLoadTest, logs its results when it's done */
+class FRealmLobbyLoadTest : public FRunnable
+{
+	struct FLoadTestClient
+	{
+		FRealmSocketListener* listener;
+
+		/* whether the listener was connected last pass, to count drops */
+		bool bWasConnected;
+
+		/* request in flight and when it was sent, 0 when idle */
+		uint32 pendingCorrelationId;
+		double sendTime;
+
+		/* where this client is in the request cycle */
+		int32 step;
+
+		FLoadTestClient()
+			: listener(nullptr)
+			, bWasConnected(false)
+			, pendingCorrelationId(0)
+			, sendTime(0.0)
+			, step(0)
+		{}
+	};
+
+	FRunnableThread* testThread;
+	FThreadSafeCounter stopTestThread;
+	FThreadSafeCounter finished;
+
+	FString host;
+	int32 port;
+	int32 clientCount;
+	float duration;
+
+	TArray<FLoadTestClient> clients;
+
+	/* round trip of every answered request, in milliseconds */
+	TArray<float> latencies;
+
+	uint32 nextCorrelationId;
+	int32 failedResponses;
+	int32 pushedMessages;
+
+	/* requests that got no answer within RequestTimeout, they're given up on and the client moves on */
+	int32 timedOutRequests;
+
+	/* times a client's connection dropped, the listener reconnects it on its own */
+	int32 droppedClients;
+
+	void SendNextRequest(FLoadTestClient& client, int32 clientIndex);
+
+	/* starts a listener for every client and waits for them to connect, returns how many did */
+	int32 ConnectClients();
+
+	void CloseClient(FLoadTestClient& client);
+
+	void ReportResults(double elapsed, double connectTime);
+
+public:
+
+	/* seconds to wait for a response before counting the request as lost */
+	static const double RequestTimeout;
+
+	/* seconds to wait for every client to connect before starting without the rest */
+	static const double ConnectTimeout;
+
+	FRealmLobbyLoadTest(const FString& inHost, int32 inPort, int32 inClientCount, float inDuration);
+	virtual ~FRealmLobbyLoadTest();
+
+	// Begin FRunnable interface.
+	virtual uint32 Run();
+	virtual void Stop();
+	// End FRunnable interface
+
+	void EnsureCompletion();
+
+	bool IsFinished() const
+	{
+		return finished.GetValue() != 0;
+	}
+};
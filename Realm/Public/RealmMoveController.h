@@ -6,6 +6,16 @@
 
 class AGameCharacter;
 
+/* how much the server cares about a unit right now, set by the significance manager */
+UENUM(BlueprintType)
+enum class ERealmSignificance : uint8
+{
+	RS_High UMETA(DisplayName = "High"),
+	RS_Medium UMETA(DisplayName = "Medium"),
+	RS_Low UMETA(DisplayName = "Low"),
+	RS_MAX UMETA(Hidden)
+};
+
 UCLASS()
 class ARealmMoveController : public AAIController
 {
@@ -24,8 +34,51 @@ protected:
 	UFUNCTION()
 	virtual void OnTargetEnterRadius(class APawn* seenPawn);
 
+	/* whether or not the significance manager should manage this controller's unit */
+	bool bUsesSignificance;
+
+	/* current significance tier */
+	ERealmSignificance significance;
+
+	/* sensing interval at full significance, scaled down with the tier */
+	float baseSensingInterval;
+
+	/* how much slower ai timers run at the current tier */
+	float GetReevaluationScale() const;
+
+	/* applies the tier to movement, avoidance and sensing, then lets subclasses rescale their timers */
+	virtual void OnSignificanceChanged(ERealmSignificance oldSignificance);
+
+	/* re-arms a repeating ai timer at the current tier's rate if it's running */
+	template<class T>
+	void RescaleRepeatingTimer(FTimerHandle& handle, T* timerObject, void (T::*timerMethod)(), float oldScale)
+	{
+		if (!GetWorldTimerManager().IsTimerActive(handle) || oldScale <= 0.f)
+			return;
+
+		const float baseRate = GetWorldTimerManager().GetTimerRate(handle) / oldScale;
+		GetWorldTimerManager().SetTimer(handle, timerObject, timerMethod, baseRate * GetReevaluationScale(), true);
+	}
+
 public:
 
+	/* movement tick interval and reevaluation scale for each tier */
+	static const float SignificanceMovementTickInterval[(uint8)ERealmSignificance::RS_MAX];
+	static const float SignificanceReevaluationScale[(uint8)ERealmSignificance::RS_MAX];
+
+	bool UsesSignificance() const
+	{
+		return bUsesSignificance;
+	}
+
+	ERealmSignificance GetSignificance() const
+	{
+		return significance;
+	}
+
+	/* [SERVER] change how much work this unit's ai and movement do */
+	void SetSignificance(ERealmSignificance newSignificance);
+
 	/* whenever the character stops auto attacking and needs a new command */
 	virtual void NeedsNewCommand();
 
@@ -25,4 +25,16 @@ public:
 	/* don't give objectives experience; it won't work */
 	UFUNCTION(BlueprintCallable, Category = Exp)
 	virtual void GiveCharacterExperience(int32 amount) override;
+
+	/* [SERVER] range the game mode's range grid tells this structure about units entering and leaving. read once at match start, 0 to not watch */
+	virtual float GetWatchedRange() const;
+
+	/* [SERVER] whether this structure cares about a unit being in its range */
+	virtual bool ShouldWatchUnit(AGameCharacter* unit) const;
+
+	/* [SERVER] a watched unit came into range */
+	virtual void OnUnitEnteredRange(AGameCharacter* unit);
+
+	/* [SERVER] a watched unit left range, died or stopped being watched */
+	virtual void OnUnitLeftRange(AGameCharacter* unit);
 };
\ No newline at end of file
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "Chat.h"
+#include "CosmeticEvent.h"
 #include "RealmPlayerController.generated.h"
 
 class ARealmMoveController;
 class APlayerCharacter;
 class ARealmPlayerState;
 class URealmFogofWarManager;
+class URealmClientSignificanceManager;
 
 UCLASS()
 class ARealmPlayerController : public APlayerController
@@ -21,9 +23,9 @@ protected:
 	UPROPERTY()
 	FTimerHandle movementTimer;
 
-	/* timer for getting in range for auto attacks */
+	/* target the hero is walking into auto attack range of, checked by the game mode's auto attack scheduler */
 	UPROPERTY()
-	FTimerHandle aaRangeTimer;
+	AGameCharacter* pursuitTarget;
 
 	/* particle system for the move command */
 	UPROPERTY()
@@ -33,6 +35,10 @@ protected:
 	UPROPERTY()
 	ARealmMoveController* moveController;
 
+	/* [CLIENT] lowers animation work for characters that are small on screen or fogged */
+	UPROPERTY()
+	URealmClientSignificanceManager* clientSignificance;
+
 	/* temporary until character select is implemented */
 	UPROPERTY()
 	TSubclassOf<APlayerCharacter> defaultCharacterClass;
@@ -53,6 +59,7 @@ protected:
 
 	/* override begin play */
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void SetupInputComponent() override;
 
 	/* [CLIENT] open the player's in-game store */
@@ -74,8 +81,80 @@ protected:
 	UFUNCTION(reliable, client)
 	void ClientSetRTSCameraViewTarget(ASpectatorCharacter* scharacter);
 
+	/* [CLIENT] last directed command sent to the server, used to skip held input that hasn't changed */
+	FVector lastCommandLocation;
+	AGameCharacter* lastCommandTarget;
+	AActor* lastCommandPickedActor;
+	bool bHasSentCommand;
+
+	/* [CLIENT] how far the cursor target has to move before held input is sent again */
+	UPROPERTY(EditDefaultsOnly, Category = Commands)
+	float commandResendDistance;
+
+	/* [SERVER] how many directed commands this connection can have processed per second */
+	UPROPERTY(EditDefaultsOnly, Category = Commands)
+	int32 maxCommandsPerSecond;
+
+	/* [SERVER] rate limiting window for directed commands */
+	float commandWindowStart;
+	int32 commandsThisWindow;
+
+	/* [SERVER] newest command that arrived over the rate limit, run once the window resets */
+	FVector pendingCommandLocation;
+	TWeakObjectPtr<AGameCharacter> pendingCommandTarget;
+	TWeakObjectPtr<AActor> pendingCommandPickedActor;
+	int32 pendingCommandId;
+	bool bHasPendingCommand;
+	FTimerHandle pendingCommandTimer;
+
+	/* [CLIENT] id of the last directed command sent, so the prediction knows when the server has caught up to it */
+	int32 sentCommandCount;
+
+	/* newest directed command the server has run, the owning client reconciles its prediction once this reaches it */
+	UPROPERTY(Replicated)
+	int32 acknowledgedCommand;
+
+	/* newest move command the server refused (stunned, dashing), the owning client drops its prediction of it */
+	UPROPERTY(ReplicatedUsing = OnRep_RejectedCommand)
+	int32 rejectedCommand;
+
+	UFUNCTION()
+	void OnRep_RejectedCommand();
+
+	/* [CLIENT] start walking the hero locally for a command that's just been sent */
+	void PredictDirectedCommand(const FVector& targetLocation, AGameCharacter* target, int32 commandId);
+
+	/* [SERVER] how many chat messages this player can send per chat interval, the rest are dropped */
+	UPROPERTY(EditDefaultsOnly, Category = Chat)
+	int32 maxChatsPerInterval;
+
+	/* [SERVER] length of the chat rate limiting window in seconds */
+	UPROPERTY(EditDefaultsOnly, Category = Chat)
+	float chatInterval;
+
+	/* [SERVER] rate limiting window for chat */
+	float chatWindowStart;
+	int32 chatsThisWindow;
+
+	/* [SERVER] moves or attacks based on a directed command. the picked actor is whatever was under the cursor, friend or
+	   foe, and goes to skills that are aiming */
+	void ExecuteDirectedCommand(const FVector& targetLocation, AGameCharacter* target, AActor* pickedActor, int32 commandId);
+
+	/* [SERVER] runs the command that was held back by the rate limit */
+	void FlushPendingDirectedCommand();
+
+	/* [SERVER] send the input data from the player to skills that are being performed in case they need the data */
+	void ProcessSkillInputData(const FHitResult& targetData);
+
 public:
 
+	/* if the auto attack scheduler is checking this player's pursuit */
+	bool bInAutoAttackSchedule;
+
+	/* [SERVER] checks if the hero has reached its pursuit target and starts the auto attack when it has.
+	   returns false once the pursuit is over */
+	bool UpdateAutoAttackPursuit();
+
 	/* info target information */
 	UPROPERTY(BlueprintReadOnly, Category = Target)
 	AGameCharacter* infoTarget;
@@ -100,9 +179,21 @@ public:
 	UFUNCTION(reliable, server, WithValidation)
 	void ServerClearAttackCommands();
 
-	/* [SERVER] send the input data from the player to skills that are being performed in case they need the data */
+	/* [SERVER] single move/attack command from held input. a null target is a move to the location, the picked actor is
+	   what was under the cursor for skills that are aiming */
 	UFUNCTION(reliable, server, WithValidation)
-	void ServerProcessSkillInputData(const FHitResult& targetData);
+	void ServerDirectedCommand(FVector_NetQuantize targetLocation, AGameCharacter* target, AActor* pickedActor, int32 commandId);
+
+	int32 GetAcknowledgedCommand() const
+	{
+		return acknowledgedCommand;
+	}
+
+	/* [CLIENT] sends a directed command unless it's the same as the last one sent */
+	void SendDirectedCommand(const FVector& targetLocation, AGameCharacter* target, AActor* pickedActor);
+
+	/* [CLIENT] forget the last directed command so the next one always goes out */
+	void ResetDirectedCommandFilter();
 
 	/* [SERVER] called when the player wants to use a skill */
 	UFUNCTION(reliable, server, WithValidation)
@@ -179,9 +270,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Commands)
 	bool GetUnitsUnderMouse(ECollisionChannel TraceChannel, bool bTraceComplex, TArray<FHitResult>& hits) const;
 
-	/* filter through and select one single unit under the mouse */
+	/* select one single unit under the mouse from the hud's screen space list, tracing for the ground if there isn't one and it's wanted */
 	UFUNCTION(BlueprintCallable, Category = Commands)
-	bool SelectUnitUnderMouse(ECollisionChannel TraceChannel, bool bTraceComplex, FHitResult& chosenHit) const;
+	bool SelectUnitUnderMouse(ECollisionChannel TraceChannel, bool bTraceComplex, FHitResult& chosenHit, bool bFallbackToGround = true) const;
 
 	/* gets the player character in range for auto attacks */
 	void GetPlayerInAutoAttackRange();
@@ -194,6 +285,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = PC)
 	APlayerCharacter* GetPlayerCharacter() const;
 
+	/* [CLIENT] gets the manager lowering animation work on this client, null for controllers that aren't local */
+	UFUNCTION(BlueprintCallable, Category = PC)
+	URealmClientSignificanceManager* GetClientSignificance() const
+	{
+		return clientSignificance;
+	}
+
 	/* override this to call the move controller's possess, if it exists */
 	virtual void Possess(APawn* aPawn) override;
 
@@ -214,9 +312,14 @@ public:
 	UFUNCTION(reliable, client)
 	void ClientShowCreditGain(const FVector& worldLoc, int32 creditAmt);
 
-	/* [CLIENT] receive a chat from the game mode */
+	/* [CLIENT] receive a chat routed to this player by the game state */
+	UFUNCTION(reliable, client)
 	void ClientReceiveChat(const FRealmChatEntry& incomingChat);
 
+	/* [CLIENT] receive a batch of montages and sounds from characters this player can see, may be dropped */
+	UFUNCTION(unreliable, client)
+	void ClientReceiveCosmeticEvents(const TArray<FRealmCosmeticEvent>& cosmeticEvents);
+
 	/* [CLIENT] player toggled their chat mode */
 	void ClientToggleChat();
 
@@ -31,6 +31,9 @@ protected:
 	/* timer for range checking */
 	FTimerHandle rangeTimer, spawnIntroTimer;
 
+	/* timer for checking whether we've reached the objective */
+	FTimerHandle objectiveTimer;
+
 	/* location that this raider spawned */
 	FVector spawnLocation;
 
@@ -40,6 +43,8 @@ protected:
 	/* check for reached objectives */
 	void CheckReachedObjective();
 
+	virtual void OnSignificanceChanged(ERealmSignificance oldSignificance) override;
+
 public:
 
 	/* lane manager that controls this minion */
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "RealmRangeGrid.generated.h"
+
+class ARealmGameMode;
+class ARealmObjective;
+class AGameCharacter;
+
+/* size of a range grid cell */
+const static float RANGE_GRID_CELL_SIZE = 400.f;
+
+/* ranges are measured to the edge of a unit's capsule like auto attacks are, so the cells a range touches are padded
+   by the widest capsule a unit can have */
+const static float RANGE_GRID_MAX_UNIT_RADIUS = 150.f;
+
+/* a structure whose range covers part of a cell */
+struct FRangeCellWatcher
+{
+	int32 watcherIndex;
+
+	/* the whole cell is inside the range, so anything in it is in range without a distance check */
+	bool bFullyCovered;
+
+	FRangeCellWatcher(int32 inWatcherIndex, bool bInFullyCovered)
+		: watcherIndex(inWatcherIndex)
+		, bFullyCovered(bInFullyCovered)
+	{}
+};
+
+/* a structure that gets told when units come in and out of its range */
+struct FRangeWatcher
+{
+	TWeakObjectPtr<ARealmObjective> structure;
+	FVector2D center;
+	float range;
+	float rangeSq;
+};
+
+/* the structures a unit is currently in range of */
+struct FRangeWatchedUnit
+{
+	TArray<int32> insideWatchers;
+};
+
+/* [SERVER] tells structures when units enter and leave their range. structures never move, so the cells each one's range
+   covers are worked out once at match start, and a unit only costs a distance check when it's standing in one of them */
+UCLASS()
+class URealmRangeGrid : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	FTimerHandle rangeTimer;
+
+	/* every structure watching its range, built on the first update so they've all begun play */
+	TArray<FRangeWatcher> watchers;
+	bool bWatchersBuilt;
+
+	/* structures whose range touches each cell, cells no range touches aren't stored */
+	TMap<FIntPoint, TArray<FRangeCellWatcher> > cells;
+
+	/* units that are or have been in a watched cell */
+	TMap<TWeakObjectPtr<AGameCharacter>, FRangeWatchedUnit> units;
+
+	/* find every structure that watches its range and mark the cells it covers */
+	void BuildWatchers();
+
+	/* check every unit against the ranges of the cell it's in */
+	void UpdateRanges();
+
+	/* tell every structure a unit is still inside that it has left */
+	void LeaveAllWatchers(AGameCharacter* unit, FRangeWatchedUnit& state);
+
+	/* whether a unit counts as inside a structure's range */
+	bool IsInsideWatcher(AGameCharacter* unit, const FRangeWatcher& watcher, bool bFullyCovered) const;
+
+	FIntPoint GetCell(const FVector& location) const;
+
+public:
+
+	/* game mode that owns this grid */
+	UPROPERTY()
+	ARealmGameMode* gameOwner;
+
+	/* seconds between updates */
+	float updateInterval;
+
+	/* starts the update timer */
+	void StartTrackingRanges();
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "RealmMoveController.h"
+#include "RealmSignificanceManager.generated.h"
+
+class ARealmGameMode;
+
+/* per controller bookkeeping so tiers don't flicker at the edges of the ranges */
+struct FSignificanceState
+{
+	/* tier the last update wanted to drop to, and how many updates in a row it's wanted it */
+	ERealmSignificance pendingSignificance;
+	int32 pendingUpdates;
+
+	FSignificanceState()
+		: pendingSignificance(ERealmSignificance::RS_High)
+		, pendingUpdates(0)
+	{}
+};
+
+/* [SERVER] sorts ai units into significance tiers by their distance to players and whether an enemy team can see them,
+   and tells their controllers to slow their ai and movement down when nobody is around to notice */
+UCLASS()
+class URealmSignificanceManager : public UObject
+{
+	GENERATED_UCLASS_BODY()
+
+protected:
+
+	FTimerHandle significanceTimer;
+
+	/* state for each managed controller, dropped when the controller goes away */
+	TMap<TWeakObjectPtr<ARealmMoveController>, FSignificanceState> controllerStates;
+
+	/* number of units in each tier after the last update */
+	int32 tierCounts[(uint8)ERealmSignificance::RS_MAX];
+
+	/* time the tier counts were last logged */
+	float lastReportTime;
+
+	/* reclassify every managed unit */
+	void UpdateSignificance();
+
+	/* the tier a unit should be in, ignoring hysteresis */
+	ERealmSignificance CalculateSignificance(AGameCharacter* unit, const TArray<FVector>& playerLocations, float margin) const;
+
+	/* whether any team but the unit's own currently has it in their sight list */
+	bool IsVisibleToEnemyTeam(AGameCharacter* unit) const;
+
+public:
+
+	/* game mode that owns this manager */
+	UPROPERTY()
+	ARealmGameMode* gameOwner;
+
+	/* units within this distance of a player are at full significance */
+	float highDistance;
+
+	/* units within this distance of a player, or seen by an enemy team, are at medium significance */
+	float mediumDistance;
+
+	/* extra distance a unit has to move past a range before it's demoted */
+	float hysteresisDistance;
+
+	/* updates in a row a unit has to qualify for a lower tier before it's demoted */
+	int32 demoteUpdates;
+
+	/* seconds between updates */
+	float updateInterval;
+
+	/* seconds between logging the tier counts, 0 to never log */
+	float reportInterval;
+
+	/* starts the update timer */
+	void StartUpdatingSignificance();
+
+	/* gets how many units were in a tier after the last update */
+	UFUNCTION(BlueprintCallable, Category = Significance)
+	int32 GetTierCount(ERealmSignificance tier) const;
+};
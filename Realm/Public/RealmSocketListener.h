@@ -1,26 +1,90 @@
 #pragma once
 
+#include "RealmLobbyProtocol.h"
+
 class URealmGameInstance;
 
+/* process wide cache of resolved lobby hosts so repeated requests skip dns */
+class FRealmHostResolver
+{
+	struct FCachedHost
+	{
+		uint32 ip;
+		double resolveTime;
+	};
+
+	static TMap<FString, FCachedHost> cachedHosts;
+	static FCriticalSection cacheLock;
+
+public:
+
+	/* how long a resolved address stays valid, in seconds */
+	static const double CacheTTL;
+
+	/* gets an address from the cache if it hasn't expired. never blocks */
+	static bool GetCachedAddress(const FString& host, uint32& outIp);
+
+	/* resolves the host, waiting on the calling thread for the lookup. never call this from the game thread */
+	static bool ResolveBlocking(const FString& host, uint32& outIp);
+
+	/* starts resolving a host on the thread pool so the cache is warm when it's needed */
+	static void Prefetch(const FString& host);
+
+	/* drops a host from the cache, used when connecting to the cached address fails */
+	static void Invalidate(const FString& host);
+};
+
+/* persistent connection to one of the lobby servers. resolves, connects, reconnects with backoff and
+   sends queued requests on its own thread; the game thread only ever enqueues and dequeues */
 class FRealmSocketListener : public FRunnable
 {
 	FRunnableThread* listenerThread;
 	FThreadSafeCounter stopListenerThread;
 
+	/* set while the socket is connected */
+	FThreadSafeCounter connected;
+
 	FSocket* listenSocket;
 
+	/* host and port we keep a connection to */
+	FString host;
+	int32 port;
+
 	bool bLoginSocket = false;
 
+	/* seconds to wait before the next connection attempt, doubles on every failure */
+	float reconnectDelay;
+	double nextConnectTime;
+
+	/* tries to resolve the host and connect, returns false and schedules another attempt on failure */
+	bool Connect();
+
+	/* closes and destroys the socket so the next loop reconnects */
+	void Disconnect();
+
+	/* sends everything that's been queued, stops at the first failure so nothing is lost */
+	void FlushOutgoing();
+
 	void ListenForData();
 
-	/* queue for uobjects to get data from this listener */
-	TQueue<TArray<uint8> > dataQueue;
+	/* splits the incoming stream into messages */
+	FLobbyCodec codec;
+
+	/* queue for uobjects to get decoded messages from this listener */
+	TQueue<FLobbyMessage> dataQueue;
+
+	/* requests waiting to be sent, filled from the game thread */
+	TQueue<TArray<uint8>, EQueueMode::Mpsc> outgoingQueue;
 
 public:
 
+	/* first and longest wait between reconnection attempts */
+	static const float MinReconnectDelay;
+	static const float MaxReconnectDelay;
+
 	URealmGameInstance* gameInstance;
 
-	FRealmSocketListener(FSocket* socketToListenTo, bool bLoginSocket);
+	FRealmSocketListener(const FString& inHost, int32 inPort, bool bLoginSocket);
 	virtual ~FRealmSocketListener();
 
 	// Begin FRunnable interface.
@@ -34,7 +98,17 @@ public:
 
 	void Shutdown();
 
-	void GetNextDataArray(TArray<uint8>& outArray);
+	/* encodes and queues a message to be sent once the connection is up */
+	void Send(const FLobbyMessage& message);
+
+	/* whether or not the connection is currently up */
+	bool IsConnected() const
+	{
+		return connected.GetValue() != 0;
+	}
+
+	/* pulls the next received message, returns false if there wasn't one */
+	bool GetNextMessage(FLobbyMessage& outMessage);
 
-	static FRealmSocketListener* CreateListener(FSocket* socketToListenTo, bool bLoginSocket);
-};
\ No newline at end of file
+	static FRealmSocketListener* CreateListener(const FString& inHost, int32 inPort, bool bLoginSocket);
+};
@@ -12,9 +12,13 @@ class ATurret : public ARealmObjective
 
 protected:
 
-	/* array of enemy units that are currently in range of this turret */
+	/* array of enemy units that are currently in range of this turret, kept in the order they should be targeted */
+	UPROPERTY()
 	TArray<AGameCharacter*> inRangeTargets;
 
+	/* targeting priority of a unit, lower goes first. minions, then objectives, then mythos. INDEX_NONE if it's never targeted */
+	int32 GetTargetPriority(AGameCharacter* unit) const;
+
 	/* override the check auto attack function to make sure the turret doesn't move */
 	virtual void CheckAutoAttack() override;
 
@@ -40,4 +44,9 @@ public:
 	virtual void OnFinishAATimer() override;
 
 	virtual void ReceiveCallForHelp(AGameCharacter* distressedUnit, AGameCharacter* enemyTarget) override;
+
+	virtual float GetWatchedRange() const override;
+	virtual bool ShouldWatchUnit(AGameCharacter* unit) const override;
+	virtual void OnUnitEnteredRange(AGameCharacter* unit) override;
+	virtual void OnUnitLeftRange(AGameCharacter* unit) override;
 };
\ No newline at end of file
@@ -4,6 +4,12 @@
 
 class AGameCharacter;
 
+/* damage type bits shields absorb, anything that isn't one of the realm damage types counts as other */
+const static uint8 SHIELD_DAMAGE_PHYSICAL = 1 << 0;
+const static uint8 SHIELD_DAMAGE_SPECIAL = 1 << 1;
+const static uint8 SHIELD_DAMAGE_TRUE = 1 << 2;
+const static uint8 SHIELD_DAMAGE_OTHER = 1 << 3;
+
 USTRUCT()
 struct FCharacterShield
 {
@@ -20,9 +26,9 @@ struct FCharacterShield
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
 	float duration;
 
-	/* timer handle for this shield */
-	UPROPERTY(BlueprintReadOnly, Category = Shield)
-	FTimerHandle timer;
+	/* shields with a higher priority absorb damage first, ties go to the one that expires soonest */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
+	int32 priority;
 
 	/* types of damage this shield absorbs */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
@@ -35,25 +41,72 @@ struct FCharacterShield
 	/* game character that created (originated) this shield */
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = Shield)
 	AGameCharacter* originatingCharacter;
+
+	/* world time this shield runs out, 0 for indefinitely lasting shields */
+	float expireTime;
+
+	/* damageTypes as damage type bits, filled in when the shield is added */
+	uint8 damageTypeMask;
+
+	FCharacterShield()
+	{
+		amountMax = 0.f;
+		amount = 0.f;
+		duration = 0.f;
+		priority = 0;
+		originatingCharacter = nullptr;
+		expireTime = 0.f;
+		damageTypeMask = 0;
+	}
+
+	/* whether or not this shield absorbs before another */
+	bool AbsorbsBefore(const FCharacterShield& other) const
+	{
+		if (priority != other.priority)
+			return priority > other.priority;
+
+		//indefinite shields go last
+		if (expireTime <= 0.f || other.expireTime <= 0.f)
+			return expireTime > 0.f && other.expireTime <= 0.f;
+
+		return expireTime < other.expireTime;
+	}
 };
 
+/* a character's shields, replicated through the owning character as a subobject.
+   shields are kept in absorb order in a small array so damage runs through them front to back */
 UCLASS()
-class AShieldManager : public AActor
+class UShieldManager : public UObject
 {
 	GENERATED_UCLASS_BODY()
 
-	/* array of shields this character currently has */
+	/* shields this character currently has, in the order they absorb damage */
 	UPROPERTY()
-	TMap<FString, FCharacterShield> shields;
+	TArray<FCharacterShield> shields;
 
-	/* replicated total shield amount for things like UI */
+	/* replicated total shield amount for things like UI, kept up to date as shields change */
 	UPROPERTY(replicated)
 	float totalShieldAmount = 0.f;
 
 protected:
 
-	/* updates the total shield amount */
-	void UpdateTotalShieldAmount();
+	/* fires when the next shield runs out */
+	FTimerHandle expiryTimer;
+
+	/* world time the expiry timer is armed for, 0 when it isn't */
+	float scheduledExpiry;
+
+	/* expiry timer callback */
+	void OnExpiryTimer();
+
+	/* removes shields that have run out and re-arms the expiry timer if the next one to run out changed */
+	void RemoveExpiredShields();
+
+	/* arms the expiry timer for the shield that runs out soonest, leaving it alone if it's already armed for that time */
+	void ScheduleNextExpiry();
+
+	/* removes the shield at an index and takes what's left of it off the total */
+	void RemoveShieldAt(int32 index);
 
 public:
 	
@@ -61,7 +114,10 @@ public:
 	UPROPERTY()
 	AGameCharacter* owningCharacter;
 
-	/* adds a shield to the array */
+	/* gets the shield damage type bit for a damage type */
+	static uint8 GetDamageTypeMask(TSubclassOf<UDamageType> damageType);
+
+	/* adds a shield, replacing any shield with the same key */
 	UFUNCTION(BlueprintCallable, Category = Shield)
 	void AddShield(FCharacterShield newShield);
 
@@ -79,7 +135,12 @@ public:
 	UFUNCTION(BlueprintCallable, Category = Effect)
 	void ShieldFinished(FCharacterShield finishingShield);
 
-	/* goes through the shields and determines whether or not the specified character has applied any shield to this character. not a fast function since we have to iterate over the entire hash map */
+	virtual bool IsSupportedForNetworking() const override
+	{
+		return true;
+	}
+
+	/* whether or not the specified character has applied any shield to this character */
 	UFUNCTION(BlueprintCallable, Category = Shield)
 	bool DoesContainCharactersShield(AGameCharacter* originatingUnit);
-};
\ No newline at end of file
+};
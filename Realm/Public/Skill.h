@@ -37,7 +37,7 @@ class ASkill : public AActor
 protected:
 
 	/* what current state the skill is in */
-	UPROPERTY(replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_SkillState)
 	TEnumAsByte<ESkillState> skillState;
 
 	/* character using this skill */
@@ -52,16 +52,12 @@ protected:
 	UPROPERTY(BlueprintReadOnly, EditDefaultsOnly, Category = Skill)
 	int32 skillPointsMax;
 
-	/* timer for cooldowns */
+	/* [SERVER] timer that moves the skill out of its cooldown state, the cooldown itself lives in the owner's cooldown table */
 	FTimerHandle cooldownTimer;
 
 	/* next state to go to after cooldown is finished */
 	ESkillState afterCooldownState;
 
-	/* for when the cooldown timer is set */
-	UPROPERTY(ReplicatedUsing = OnCooldownTimerSet)
-	float cooldownTime;
-
 	/* whether or not this skill automatically enters the performing state on use */
 	UPROPERTY(EditDefaultsOnly, Category = Skill)
 	bool bAutoPerform;
@@ -93,8 +89,11 @@ protected:
 	/* called when cooldown is finished */
 	void CooldownFinished();
 
+	/* skills only tick while they're being performed */
+	void UpdateTickForState();
+
 	UFUNCTION()
-	void OnCooldownTimerSet();
+	void OnRep_SkillState();
 
 public:
 
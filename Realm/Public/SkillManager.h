@@ -5,8 +5,9 @@
 
 class ASkill;
 
+/* holds a character's skills, replicated through the owning character as a subobject instead of being an actor of its own */
 UCLASS()
-class ASkillManager : public AActor
+class USkillManager : public UObject
 {
 	GENERATED_UCLASS_BODY()
 
@@ -32,4 +33,12 @@ public:
 	/* get the array of skills */
 	UFUNCTION(BlueprintCallable, Category = Skill)
 	void GetSkills(TArray<ASkill*>& outSkills);
+
+	/* [SERVER] destroys the skills along with the character */
+	void DestroySkills();
+
+	virtual bool IsSupportedForNetworking() const override
+	{
+		return true;
+	}
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 class AMod;
 class AGameCharacter;
 class AEffect;
+class UStatsManager;
 
 UENUM(BlueprintType)
 enum class EStat : uint8
@@ -39,6 +40,132 @@ enum class EStat : uint8
 	ES_Max UMETA(Hidden)
 };
 
+/* stats that grow every level, each paired with the stat holding how much it grows by */
+const static int32 LEVELED_STAT_COUNT = 9;
+const static EStat LEVELED_STATS[LEVELED_STAT_COUNT][2] =
+{
+	{ EStat::ES_HP, EStat::ES_HPPL },
+	{ EStat::ES_Flare, EStat::ES_FlarePL },
+	{ EStat::ES_HPRegen, EStat::ES_HPRegenPL },
+	{ EStat::ES_FlareRegen, EStat::ES_FlareRegenPL },
+	{ EStat::ES_SpAtk, EStat::ES_SpAtkPL },
+	{ EStat::ES_Atk, EStat::ES_AtkPL },
+	{ EStat::ES_Def, EStat::ES_DefPL },
+	{ EStat::ES_SpDef, EStat::ES_SpDefPL },
+	{ EStat::ES_AtkSp, EStat::ES_AtkSpPL },
+};
+
+/* stats are sent to clients as fixed point values with this many steps per whole unit */
+const static float STAT_QUANTIZE_SCALE = 1000.f;
+
+/* quantized copy of a single stat that only goes over the network when it changes */
+USTRUCT()
+struct FReplicatedStat
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	float baseValue;
+
+	UPROPERTY()
+	float modValue;
+
+	UPROPERTY()
+	float bonusValue;
+
+	FReplicatedStat()
+		: baseValue(0.f)
+		, modValue(0.f)
+		, bonusValue(0.f)
+	{}
+
+	FReplicatedStat(float inBase, float inMod, float inBonus)
+		: baseValue(Quantize(inBase))
+		, modValue(Quantize(inMod))
+		, bonusValue(Quantize(inBonus))
+	{}
+
+	/* rounds a value to what the client will actually receive */
+	static float Quantize(float value)
+	{
+		return FMath::RoundToInt(value * STAT_QUANTIZE_SCALE) / STAT_QUANTIZE_SCALE;
+	}
+
+	bool operator==(const FReplicatedStat& other) const
+	{
+		return baseValue == other.baseValue && modValue == other.modValue && bonusValue == other.bonusValue;
+	}
+
+	/* packs the values as variable length fixed point, skipping the mod and bonus values when they're zero */
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedStat> : public TStructOpsTypeTraitsBase
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+/* entry in the replicated effect list */
+USTRUCT()
+struct FEffectItem : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	/* the effect actor */
+	UPROPERTY()
+	AEffect* effect;
+
+	/* key the effect was added under */
+	UPROPERTY()
+	FString keyName;
+
+	FEffectItem()
+		: effect(nullptr)
+	{}
+
+	/* client callbacks for the fast array */
+	void PreReplicatedRemove(const struct FEffectList& list);
+	void PostReplicatedAdd(const struct FEffectList& list);
+	void PostReplicatedChange(const struct FEffectList& list);
+};
+
+/* list of effects on a character, replicated per item instead of as a whole array */
+USTRUCT()
+struct FEffectList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<FEffectItem> items;
+
+	/* stats manager that owns this list */
+	UPROPERTY(NotReplicated)
+	UStatsManager* owner;
+
+	FEffectList()
+		: owner(nullptr)
+	{}
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FastArrayDeltaSerialize<FEffectItem>(items, DeltaParms, *this);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FEffectList> : public TStructOpsTypeTraitsBase
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
 UCLASS()
 class UStatsManager : public UObject
 {
@@ -46,6 +173,7 @@ class UStatsManager : public UObject
 	friend class AEffect;
 	friend class AGameCharacter;
 	friend class ARaiderCharacter;
+	friend struct FEffectItem;
 
 	GENERATED_UCLASS_BODY()
 
@@ -56,13 +184,21 @@ protected:
 	bool bInitialized;
 
 	/* array of base stats for the character */
-	UPROPERTY(replicated)
+	UPROPERTY()
 	float baseStats[(uint8)EStat::ES_Max];
 
 	/* array of mod stats for the character */
-	UPROPERTY(replicated)
+	UPROPERTY()
 	float modStats[(uint8)EStat::ES_Max];
 
+	/* quantized stats sent to clients, only the entries that changed go out */
+	UPROPERTY(ReplicatedUsing = OnRepStats)
+	FReplicatedStat replicatedStats[(uint8)EStat::ES_Max];
+
+	/* unpack the replicated stats into the stat arrays */
+	UFUNCTION()
+	void OnRepStats();
+
 	/* current health for t	he character */
 	UPROPERTY(replicated)
 	float health;
@@ -75,28 +211,38 @@ protected:
 	UPROPERTY(replicated)
 	AGameCharacter* owningCharacter;
 
-	/* dynamic array of effects that are currently affecting this character */
-	UPROPERTY(ReplicatedUsing = OnRepUpdateEffects)
-	TArray<AEffect*> effectsList;
+	/* effects that are currently affecting this character */
+	UPROPERTY(replicated)
+	FEffectList effects;
 
 	/* map for faster effect lookup */
 	TMap<FString, AEffect*> effectsMap;
 
-	UFUNCTION()
-	void OnRepUpdateEffects();
+	/* adds an effect to the replicated list */
+	void AddEffectItem(AEffect* effect, const FString& keyName);
+
+	/* removes an effect from the replicated list */
+	void RemoveEffectItem(AEffect* effect);
+
+	/* client side handling for the effect list */
+	void OnEffectAdded(AEffect* effect, const FString& keyName);
+	void OnEffectRemoved(AEffect* effect, const FString& keyName);
 
 public:
 
-	/* array of base stats for the character */
-	UPROPERTY(replicated)
+	/* array of bonus stats for the character */
+	UPROPERTY()
 	float bonusStats[(uint8)EStat::ES_Max];
 
+	/* copies any stats that changed into the replicated stats. called by the owning character before it replicates */
+	void UpdateReplicatedStats();
+
 	/* set the health and flare */
 	void SetMaxHealth();
 	void SetMaxFlare();
 
 	/* initialize the stats manager with a character's base stats */
-	void InitializeStats(float* initBaseStats, AGameCharacter* ownerChar);
+	void InitializeStats(const float* initBaseStats, AGameCharacter* ownerChar);
 
 	/* gets the current value of the specified stat */
 	UFUNCTION(BlueprintCallable, Category = Stat)
@@ -133,8 +279,11 @@ public:
 	{
 		outEffects.Empty();
 
-		for (int32 i = 0; i < effectsList.Num(); i++)
-			outEffects.Add(effectsList[i]);
+		for (const FEffectItem& item : effects.items)
+		{
+			if (IsValid(item.effect))
+				outEffects.Add(item.effect);
+		}
 	}
 
 	/* get the effects array */
@@ -157,8 +306,8 @@ public:
 	/* get flare */
 	float GetFlare() const;
 
-	/* level up stats */
-	void CharacterLevelUp();
+	/* level up stats using the character data's level table rows, levelsGained is how many levels apart the rows are */
+	void CharacterLevelUp(const float* previousLevelStats, const float* newLevelStats, int32 levelsGained = 1);
 
 	/* networking support for uobject */
 	virtual bool IsSupportedForNetworking() const override
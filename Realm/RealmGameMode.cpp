@@ -12,6 +12,12 @@
 #include "GameCharacter.h"
 #include "RealmPlayerStart.h"
 #include "RealmFogofWarManager.h"
+#include "RealmSignificanceManager.h"
+#include "RealmCosmeticChannel.h"
+#include "RealmAutoAttackScheduler.h"
+#include "RealmRangeGrid.h"
+#include "RealmLaneAvoidance.h"
+#include "RealmLagCompensation.h"
 #include "RealmGameInstance.h"
 #include "RealmGameState.h"
 #include "RealmObjective.h"
@@ -50,6 +56,9 @@ ARealmGameMode::ARealmGameMode(const FObjectInitializer& objectInitializer)
 	bRankedGame = true;
 
 	ambientLevelUpTime = 130.f;
+
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
 }
 
 void ARealmGameMode::StartMatch()
@@ -220,12 +229,81 @@ void ARealmGameMode::BeginPlay()
 	fogOfWar->enemySightLists.Add(sightList);
 
 	fogOfWar->StartCalculatingVisibility();
+
+	FString significanceName = GetFName().ToString() + ".significanceManager";
+	significanceManager = NewObject<URealmSignificanceManager>(this, FName(*significanceName));
+	significanceManager->gameOwner = this;
+	significanceManager->StartUpdatingSignificance();
+
+	FString cosmeticName = GetFName().ToString() + ".cosmeticChannel";
+	cosmeticChannel = NewObject<URealmCosmeticChannel>(this, FName(*cosmeticName));
+	cosmeticChannel->gameOwner = this;
+
+	FString schedulerName = GetFName().ToString() + ".autoAttackScheduler";
+	autoAttackScheduler = NewObject<URealmAutoAttackScheduler>(this, FName(*schedulerName));
+	autoAttackScheduler->gameOwner = this;
+
+	FString rangeGridName = GetFName().ToString() + ".rangeGrid";
+	rangeGrid = NewObject<URealmRangeGrid>(this, FName(*rangeGridName));
+	rangeGrid->gameOwner = this;
+	rangeGrid->StartTrackingRanges();
+
+	FString avoidanceName = GetFName().ToString() + ".laneAvoidance";
+	laneAvoidance = NewObject<URealmLaneAvoidance>(this, FName(*avoidanceName));
+	laneAvoidance->gameOwner = this;
+
+	FString lagCompensationName = GetFName().ToString() + ".lagCompensation";
+	lagCompensation = NewObject<URealmLagCompensation>(this, FName(*lagCompensationName));
+	lagCompensation->gameOwner = this;
+
+	//fresh match waiting for players, whether this process just booted or was recycled
+	URealmGameInstance* instance = Cast<URealmGameInstance>(GetGameInstance());
+	if (instance)
+		instance->ServerReadyForMatch(this);
 }
 
 void ARealmGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
+	if (IsValid(lagCompensation))
+	{
+		lagCompensation->ConditionalBeginDestroy();
+		lagCompensation = nullptr;
+	}
+
+	if (IsValid(laneAvoidance))
+	{
+		laneAvoidance->ConditionalBeginDestroy();
+		laneAvoidance = nullptr;
+	}
+
+	if (IsValid(rangeGrid))
+	{
+		GetWorldTimerManager().ClearAllTimersForObject(rangeGrid);
+		rangeGrid->ConditionalBeginDestroy();
+		rangeGrid = nullptr;
+	}
+
+	if (IsValid(autoAttackScheduler))
+	{
+		autoAttackScheduler->ConditionalBeginDestroy();
+		autoAttackScheduler = nullptr;
+	}
+
+	if (IsValid(cosmeticChannel))
+	{
+		cosmeticChannel->ConditionalBeginDestroy();
+		cosmeticChannel = nullptr;
+	}
+
+	if (IsValid(significanceManager))
+	{
+		GetWorldTimerManager().ClearAllTimersForObject(significanceManager);
+		significanceManager->ConditionalBeginDestroy();
+		significanceManager = nullptr;
+	}
+
 	if (IsValid(fogOfWar))
 	{
 		fogOfWar->ConditionalBeginDestroy();
@@ -235,6 +313,27 @@ void ARealmGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	}
 }
 
+void ARealmGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	//characters have moved for this frame, remember where they ended up before anything shoots at them
+	if (IsValid(lagCompensation))
+		lagCompensation->RecordPositions();
+
+	//auto attacks go first so the montages and sounds they play make this frame's batches
+	if (IsValid(autoAttackScheduler))
+		autoAttackScheduler->UpdateAutoAttacks();
+
+	//steering solved now is picked up by path following next frame
+	if (IsValid(laneAvoidance))
+		laneAvoidance->UpdateAvoidance();
+
+	//everything played this frame goes out together, after the characters have ticked
+	if (IsValid(cosmeticChannel))
+		cosmeticChannel->FlushEvents();
+}
+
 void ARealmGameMode::PostLogin(APlayerController* NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
@@ -12,6 +12,12 @@ class APlayerCharacter;
 class ARealmPlayerState;
 class AGameCharacter;
 class URealmFogofWarManager;
+class URealmSignificanceManager;
+class URealmCosmeticChannel;
+class URealmAutoAttackScheduler;
+class URealmRangeGrid;
+class URealmLaneAvoidance;
+class URealmLagCompensation;
 class ARealmObjective;
 class ALaneManager;
 
@@ -177,6 +183,9 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	/* sends out the frame's cosmetic events */
+	virtual void Tick(float DeltaSeconds) override;
+
 	/* each time a player logs in, check to see if we can start the game */
 	void CheckForCharacterSelect();
 
@@ -216,6 +225,30 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = Sight)
 	URealmFogofWarManager* fogOfWar;
 
+	/* lowers ai and movement work for units nobody is near */
+	UPROPERTY(BlueprintReadOnly, Category = Significance)
+	URealmSignificanceManager* significanceManager;
+
+	/* batches montages and sounds to the players that can see them */
+	UPROPERTY()
+	URealmCosmeticChannel* cosmeticChannel;
+
+	/* steps every auto attack in the game once per frame */
+	UPROPERTY()
+	URealmAutoAttackScheduler* autoAttackScheduler;
+
+	/* tells turrets and enablers when units come in and out of their range */
+	UPROPERTY()
+	URealmRangeGrid* rangeGrid;
+
+	/* steers lane minions around each other */
+	UPROPERTY()
+	URealmLaneAvoidance* laneAvoidance;
+
+	/* remembers where characters were so shots can be checked against what the shooter saw */
+	UPROPERTY()
+	URealmLagCompensation* lagCompensation;
+
 	/* pool of characters that are currently available for sight in this game */
 	UPROPERTY(BlueprintReadOnly, Category = Sight)
 	TArray<AGameCharacter*> availableSightUnits;